@@ -0,0 +1,125 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Minimal self-registering benchmark harness; all benchmarks link into one binary
+struct BenchState;
+
+struct BenchCase {
+    const char* name;
+    std::function<void(BenchState&)> body;
+};
+
+inline std::vector<BenchCase>& benchRegistry() {
+    static std::vector<BenchCase> benches;
+    return benches;
+}
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, std::function<void(BenchState&)> body) {
+        benchRegistry().push_back({name, std::move(body)});
+    }
+};
+
+// Hardware cache-miss counter for the calling thread; reports -1 when the
+// kernel does not expose perf events (containers, perf_event_paranoid)
+class CacheMissCounter {
+private:
+    int fd = -1;
+
+public:
+    CacheMissCounter() {
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#if defined(__linux__)
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    void start() {
+#if defined(__linux__)
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+#if defined(__linux__)
+        long long count = 0;
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) == sizeof(count)) {
+                return count;
+            }
+        }
+#endif
+        return -1;
+    }
+};
+
+// Global operator new calls so far, counted by bench_main.cpp's replacement
+std::size_t benchHeapAllocations();
+
+struct BenchState {
+    std::size_t iterations;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    CacheMissCounter* misses = nullptr;
+    std::size_t allocationsAtStart = benchHeapAllocations();
+
+    // Call after per-run setup so only the measured loop is timed and counted
+    void resetTimer() {
+        if (misses != nullptr) {
+            misses->start();
+        }
+        allocationsAtStart = benchHeapAllocations();
+        start = std::chrono::steady_clock::now();
+    }
+};
+
+// Keeps the optimizer from discarding a value the benchmark computed
+template <typename T>
+inline void doNotOptimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+
+#define BENCH(name)                                                            \
+    static void name(BenchState& state);                                       \
+    static BenchRegistrar BENCH_CONCAT(name, _registrar)(#name, &name);        \
+    static void name(BenchState& state)
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "BitmapPool.hpp"
+#include "MemoryPool.hpp"
+
+namespace {
+
+constexpr std::size_t kBlocks = 1 << 16;
+constexpr std::size_t kChurn = 256;
+
+// Fills the pool, then repeatedly frees and reallocates kChurn scattered blocks
+template <typename Pool>
+void churn(BenchState& state, Pool& pool) {
+    std::vector<void*> blocks(kBlocks);
+    for (void*& block : blocks) {
+        block = pool.allocate();
+    }
+    std::mt19937 rng(1);
+    std::vector<std::size_t> victims(kChurn);
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; i += kChurn) {
+        for (std::size_t& victim : victims) {
+            victim = rng() % kBlocks;
+        }
+        std::sort(victims.begin(), victims.end());
+        victims.erase(std::unique(victims.begin(), victims.end()), victims.end());
+        for (std::size_t victim : victims) {
+            pool.deallocate(blocks[victim]);
+        }
+        for (std::size_t victim : victims) {
+            blocks[victim] = pool.allocate();
+        }
+        doNotOptimize(blocks.data());
+        victims.resize(kChurn);
+    }
+}
+
+} // namespace
+
+BENCH(bitmap_pool_scattered_churn) {
+    BitmapPool pool(64, kBlocks);
+    churn(state, pool);
+}
+
+BENCH(memory_pool_scattered_churn) {
+    MemoryPool pool(64, kBlocks, ContiguousBlocks{});
+    churn(state, pool);
+}
@@ -0,0 +1,60 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "BufferPool.hpp"
+
+namespace {
+
+constexpr std::size_t kRecords = 64;
+constexpr std::size_t kRecordLength = 40;
+
+// Length-prefixed records laid out the way they arrive from the socket
+template <typename Bytes>
+std::size_t fillRecords(Bytes* bytes) {
+    std::size_t at = 0;
+    for (std::size_t i = 0; i < kRecords; ++i) {
+        bytes[at] = static_cast<Bytes>(kRecordLength);
+        std::memset(bytes + at + 1, 'a' + static_cast<int>(i % 26), kRecordLength);
+        at += 1 + kRecordLength;
+    }
+    return at;
+}
+
+} // namespace
+
+// Baseline: read into a vector<char> and copy each payload into a string
+BENCH(parse_records_copying_strings) {
+    std::vector<char> readBuffer(4096);
+    std::size_t length = fillRecords(readBuffer.data());
+    std::vector<std::string> parsed;
+    parsed.reserve(kRecords);
+    for (std::size_t i = 0; i < state.iterations; i += kRecords) {
+        parsed.clear();
+        for (std::size_t at = 0; at < length;) {
+            std::size_t size = static_cast<unsigned char>(readBuffer[at]);
+            parsed.emplace_back(readBuffer.data() + at + 1, size);
+            at += 1 + size;
+        }
+        doNotOptimize(parsed.data());
+    }
+}
+
+BENCH(parse_records_buffer_slices) {
+    BufferPool pool(4096, 4);
+    Buffer buffer = pool.acquire();
+    buffer.setSize(fillRecords(buffer.data()));
+    std::vector<BufferSlice> parsed;
+    parsed.reserve(kRecords);
+    for (std::size_t i = 0; i < state.iterations; i += kRecords) {
+        parsed.clear();
+        BufferSlice stream = buffer.filledSlice();
+        for (std::size_t at = 0; at < stream.size();) {
+            std::size_t size = stream.data()[at];
+            parsed.push_back(stream.slice(at + 1, size));
+            at += 1 + size;
+        }
+        doNotOptimize(parsed.data());
+    }
+}
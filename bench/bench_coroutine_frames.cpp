@@ -0,0 +1,162 @@
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include "BenchHarness.hpp"
+#include "CoroutineFramePool.hpp"
+
+namespace {
+
+struct GlobalHeapFrame {};
+
+// Lazy task with symmetric transfer back to its awaiter
+template <typename T, typename FrameAllocation>
+class Task {
+public:
+    struct promise_type : FrameAllocation {
+        T value{};
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                std::coroutine_handle<> next = handle.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_value(T result) { value = std::move(result); }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume() { return std::move(handle.promise().value); }
+
+    // Drives a top-level task to completion
+    T run() {
+        handle.resume();
+        return std::move(handle.promise().value);
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T, typename FrameAllocation>
+class Generator {
+public:
+    struct promise_type : FrameAllocation {
+        T current{};
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(T value) {
+            current = std::move(value);
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Generator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    Generator(Generator&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    ~Generator() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    bool next() {
+        handle.resume();
+        return !handle.done();
+    }
+
+    const T& value() const { return handle.promise().current; }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <typename FrameAllocation>
+Task<long, FrameAllocation> leaf(long value) {
+    co_return value * 2;
+}
+
+template <typename FrameAllocation>
+Task<long, FrameAllocation> request(long value) {
+    long a = co_await leaf<FrameAllocation>(value);
+    long b = co_await leaf<FrameAllocation>(value + 1);
+    co_return a + b;
+}
+
+template <typename FrameAllocation>
+Generator<long, FrameAllocation> countTo(long limit) {
+    for (long i = 0; i < limit; ++i) {
+        co_yield i;
+    }
+}
+
+template <typename FrameAllocation>
+void runTasks(BenchState& state) {
+    long sum = 0;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        sum += request<FrameAllocation>(static_cast<long>(i)).run();
+    }
+    doNotOptimize(sum);
+}
+
+template <typename FrameAllocation>
+void runGenerators(BenchState& state) {
+    long sum = 0;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        auto numbers = countTo<FrameAllocation>(4);
+        while (numbers.next()) {
+            sum += numbers.value();
+        }
+    }
+    doNotOptimize(sum);
+}
+
+} // namespace
+
+// Three frames per iteration: request plus two awaited leaves
+BENCH(coroutine_task_global_new) {
+    runTasks<GlobalHeapFrame>(state);
+}
+
+BENCH(coroutine_task_pooled_frames) {
+    runTasks<PoolAllocatedFrame>(state);
+}
+
+BENCH(coroutine_generator_global_new) {
+    runGenerators<GlobalHeapFrame>(state);
+}
+
+BENCH(coroutine_generator_pooled_frames) {
+    runGenerators<PoolAllocatedFrame>(state);
+}
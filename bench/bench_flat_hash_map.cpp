@@ -0,0 +1,81 @@
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "FlatHashMap.hpp"
+#include "PoolContainers.hpp"
+
+namespace {
+
+constexpr std::size_t kEntries = 1 << 17;
+
+std::vector<std::uint64_t> randomIds(std::size_t count) {
+    std::vector<std::uint64_t> ids(count);
+    std::uint64_t seed = 0x2545F4914F6CDD1Dull;
+    for (std::uint64_t& id : ids) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        id = seed;
+    }
+    return ids;
+}
+
+template <typename Map>
+void lookupLoop(BenchState& state, const Map& map, const std::vector<std::uint64_t>& ids) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        sum += map.find(ids[(i * 7919) % ids.size()])->second;
+    }
+    doNotOptimize(sum);
+}
+
+} // namespace
+
+BENCH(id_cache_pool_unordered_map_lookup) {
+    std::vector<std::uint64_t> ids = randomIds(kEntries);
+    SizeClassedPool pools(kEntries);
+    pool_unordered_map<std::uint64_t, std::uint64_t> map(pools);
+    for (std::uint64_t id : ids) {
+        map.emplace(id, id);
+    }
+    state.resetTimer();
+    lookupLoop(state, map, ids);
+}
+
+BENCH(id_cache_flat_hash_map_lookup) {
+    std::vector<std::uint64_t> ids = randomIds(kEntries);
+    SizeClassedPool pools(64, 1 << 23);
+    FlatHashMap<std::uint64_t, std::uint64_t> map(pools);
+    for (std::uint64_t id : ids) {
+        map.try_emplace(id, id);
+    }
+    state.resetTimer();
+    lookupLoop(state, map, ids);
+}
+
+BENCH(id_cache_flat_hash_map_insert_erase) {
+    std::vector<std::uint64_t> ids = randomIds(1024);
+    SizeClassedPool pools(64, 1 << 16);
+    FlatHashMap<std::uint64_t, std::uint64_t> map(pools);
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        std::uint64_t id = ids[i % ids.size()];
+        if (!map.try_emplace(id, i).second) {
+            map.erase(id);
+        }
+    }
+    doNotOptimize(map.size());
+}
+
+BENCH(id_cache_std_unordered_map_insert_erase) {
+    std::vector<std::uint64_t> ids = randomIds(1024);
+    std::unordered_map<std::uint64_t, std::uint64_t> map;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        std::uint64_t id = ids[i % ids.size()];
+        if (!map.try_emplace(id, i).second) {
+            map.erase(id);
+        }
+    }
+    doNotOptimize(map.size());
+}
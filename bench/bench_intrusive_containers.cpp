@@ -0,0 +1,106 @@
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "IntrusiveContainers.hpp"
+#include "PoolContainers.hpp"
+#include "PoolManager.hpp"
+
+namespace {
+
+// Live orders per book; each iteration adds one and cancels the oldest
+constexpr std::size_t kLiveOrders = 1024;
+
+struct ByPrice;
+struct ById;
+
+struct Order : TreeHook<ByPrice>, HashHook<ById> {
+    std::uint64_t id;
+    int price;
+};
+
+struct PriceOrder {
+    bool operator()(const Order& a, const Order& b) const { return a.price < b.price; }
+};
+
+struct IdHash {
+    std::size_t operator()(const Order& order) const { return std::hash<std::uint64_t>()(order.id); }
+};
+
+struct IdEqual {
+    bool operator()(const Order& a, const Order& b) const { return a.id == b.id; }
+};
+
+int priceFor(std::uint64_t id) {
+    return static_cast<int>((id * 2654435761u) % 512);
+}
+
+// Orders are created once from a PoolManager; each iteration re-prices one
+// order, taking it out of both indices and putting it back
+std::vector<std::unique_ptr<Order, std::function<void(Order*)>>> createOrders(PoolManager& manager) {
+    std::vector<std::unique_ptr<Order, std::function<void(Order*)>>> orders;
+    for (std::size_t i = 0; i < kLiveOrders; ++i) {
+        orders.push_back(manager.create<Order>());
+        orders.back()->id = i;
+        orders.back()->price = priceFor(i);
+    }
+    return orders;
+}
+
+} // namespace
+
+// Node containers: every index insert takes a node from the pools
+BENCH(pool_node_indices_reprice) {
+    PoolManager manager(sizeof(Order), kLiveOrders);
+    auto orders = createOrders(manager);
+    SizeClassedPool pools(kLiveOrders * 2);
+    using PriceIndex = std::multimap<int, Order*, std::less<int>, PoolAllocator<std::pair<const int, Order*>>>;
+    PriceIndex byPrice(pools);
+    pool_unordered_map<std::uint64_t, Order*> byId(pools);
+    byId.reserve(kLiveOrders * 2);
+    std::vector<PriceIndex::iterator> priceEntries;
+    for (auto& order : orders) {
+        priceEntries.push_back(byPrice.emplace(order->price, order.get()));
+        byId.emplace(order->id, order.get());
+    }
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        std::size_t index = i % kLiveOrders;
+        Order& order = *orders[index];
+        byPrice.erase(priceEntries[index]);
+        byId.erase(order.id);
+        order.id += kLiveOrders;
+        order.price = priceFor(order.id);
+        priceEntries[index] = byPrice.emplace(order.price, &order);
+        byId.emplace(order.id, &order);
+    }
+    doNotOptimize(byId.size());
+}
+
+// Intrusive indices: the hooks live in the order, so indexing allocates nothing
+BENCH(intrusive_indices_reprice) {
+    PoolManager manager(sizeof(Order), kLiveOrders);
+    auto orders = createOrders(manager);
+    IntrusiveTree<Order, ByPrice, PriceOrder> byPrice;
+    IntrusiveHashTable<Order, ById, IdHash, IdEqual> byId(kLiveOrders * 2);
+    for (auto& order : orders) {
+        byPrice.insert(*order);
+        byId.insert(*order);
+    }
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        Order& order = *orders[i % kLiveOrders];
+        byPrice.remove(order);
+        byId.remove(order);
+        order.id += kLiveOrders;
+        order.price = priceFor(order.id);
+        byPrice.insert(order);
+        byId.insert(order);
+    }
+    byPrice.clear(); // Unlink before the orders go back to the pool
+    byId.clear();
+    doNotOptimize(byId.size());
+}
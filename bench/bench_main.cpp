@@ -0,0 +1,68 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "BenchHarness.hpp"
+
+namespace {
+
+std::atomic<std::size_t> heapAllocations{0};
+
+} // namespace
+
+std::size_t benchHeapAllocations() {
+    return heapAllocations.load(std::memory_order_relaxed);
+}
+
+// Counts heap allocations so each benchmark can report the mallocs it makes
+void* operator new(std::size_t bytes) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(bytes == 0 ? 1 : bytes)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// Usage: bench [filter] [iterations]
+// Runs every benchmark whose name contains the filter and prints ns/op and
+// heap allocations per op, plus cache misses per op when hardware counters
+// are available.
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : "";
+    std::size_t iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+
+    for (const BenchCase& bench : benchRegistry()) {
+        if (std::strstr(bench.name, filter) == nullptr) {
+            continue;
+        }
+        BenchState warmup{iterations / 10 + 1};
+        bench.body(warmup);
+
+        CacheMissCounter misses;
+        BenchState state{iterations};
+        state.misses = &misses;
+        state.resetTimer();
+        bench.body(state);
+        auto elapsed = std::chrono::steady_clock::now() - state.start;
+        long long missCount = misses.stop();
+        std::size_t allocations = benchHeapAllocations() - state.allocationsAtStart;
+
+        double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        std::printf("%-48s %12.2f ns/op %10.3f allocs/op", bench.name, ns / static_cast<double>(iterations),
+                    static_cast<double>(allocations) / static_cast<double>(iterations));
+        if (missCount >= 0) {
+            std::printf(" %10.3f misses/op", static_cast<double>(missCount) / static_cast<double>(iterations));
+        }
+        std::printf("\n");
+    }
+    return EXIT_SUCCESS;
+}
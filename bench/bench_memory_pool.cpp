@@ -0,0 +1,63 @@
+#include <cstdlib>
+#include <memory>
+
+#include "BenchHarness.hpp"
+#include "PoolManager.hpp"
+
+namespace {
+
+struct Payload {
+    long values[6];
+
+    explicit Payload(long seed) {
+        for (long& value : values) {
+            value = seed++;
+        }
+    }
+};
+
+constexpr std::size_t kBatch = 64;
+
+} // namespace
+
+BENCH(pool_allocate_deallocate_batch) {
+    MemoryPool pool(64, kBatch);
+    void* blocks[kBatch];
+    for (std::size_t i = 0; i < state.iterations; i += kBatch) {
+        for (void*& block : blocks) {
+            block = pool.allocate();
+        }
+        doNotOptimize(blocks);
+        for (void* block : blocks) {
+            pool.deallocate(block);
+        }
+    }
+}
+
+BENCH(malloc_free_batch) {
+    void* blocks[kBatch];
+    for (std::size_t i = 0; i < state.iterations; i += kBatch) {
+        for (void*& block : blocks) {
+            block = std::malloc(64);
+        }
+        doNotOptimize(blocks);
+        for (void* block : blocks) {
+            std::free(block);
+        }
+    }
+}
+
+BENCH(pool_manager_create) {
+    PoolManager manager(sizeof(Payload), 1);
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        auto payload = manager.create<Payload>(static_cast<long>(i));
+        doNotOptimize(payload->values[0]);
+    }
+}
+
+BENCH(std_make_unique) {
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        auto payload = std::make_unique<Payload>(static_cast<long>(i));
+        doNotOptimize(payload->values[0]);
+    }
+}
@@ -0,0 +1,35 @@
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "PerCpuPool.hpp"
+
+namespace {
+
+constexpr std::size_t kBatch = 16;
+
+void allocateFree(BenchState& state, PerCpuPool& pool) {
+    std::vector<void*> blocks(kBatch);
+    state.resetTimer();
+    for (std::size_t done = 0; done < state.iterations; done += kBatch) {
+        for (void*& block : blocks) {
+            block = pool.allocate();
+        }
+        for (void* block : blocks) {
+            pool.deallocate(block);
+        }
+    }
+}
+
+} // namespace
+
+// rseq push/pop on the current CPU's cache (falls back when rseq is unavailable)
+BENCH(per_cpu_pool_allocate_free) {
+    PerCpuPool pool(64, 4096, 64);
+    allocateFree(state, pool);
+}
+
+// Same pool forced onto PoolManager's thread caches
+BENCH(per_cpu_pool_thread_cache_allocate_free) {
+    PerCpuPool pool(64, 4096, 64, CacheMode::perThread);
+    allocateFree(state, pool);
+}
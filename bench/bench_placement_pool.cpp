@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "PlacementPool.hpp"
+
+namespace {
+
+constexpr std::size_t kObjects = 1 << 18; // 16 MiB of 64-byte blocks, well past the LLC
+
+struct Record {
+    std::uint64_t key;
+    std::uint64_t value;
+};
+
+// Fills the pool, frees half of it in random order, then builds a live set
+// of a quarter of the pool and times passes over that set in creation
+// order. The policy decides how scattered the new objects are.
+template <typename Placement>
+void iterateAll(BenchState& state, std::size_t blockSize, std::size_t objects, bool cacheColoring) {
+    PlacementPool<Placement> pool(blockSize, objects, cacheColoring);
+    std::vector<void*> blocks(objects);
+    for (void*& block : blocks) {
+        block = pool.allocate();
+    }
+    std::shuffle(blocks.begin(), blocks.end(), std::mt19937(3));
+    for (std::size_t i = 0; i < objects / 2; ++i) {
+        pool.deallocate(blocks[i]);
+    }
+    std::vector<Record*> live(objects / 4);
+    for (std::size_t i = 0; i < live.size(); ++i) {
+        live[i] = new (pool.allocate()) Record{i, i * 3};
+    }
+
+    state.resetTimer();
+    std::uint64_t sum = 0;
+    for (std::size_t done = 0; done < state.iterations; done += live.size()) {
+        for (Record* record : live) {
+            sum += record->value;
+        }
+        doNotOptimize(sum);
+    }
+}
+
+} // namespace
+
+BENCH(placement_lifo_iterate_all) {
+    iterateAll<LifoPlacement>(state, 64, kObjects, false);
+}
+
+BENCH(placement_address_ordered_iterate_all) {
+    iterateAll<AddressOrderedPlacement>(state, 64, kObjects, false);
+}
+
+BENCH(placement_fullest_page_iterate_all) {
+    iterateAll<FullestPagePlacement>(state, 64, kObjects, false);
+}
+
+// 1000-byte objects leave 64 bytes of slack per page: two colors (32 MiB slab)
+BENCH(placement_uncolored_iterate_all_1k) {
+    iterateAll<AddressOrderedPlacement>(state, 1000, kObjects / 8, false);
+}
+
+BENCH(placement_colored_iterate_all_1k) {
+    iterateAll<AddressOrderedPlacement>(state, 1000, kObjects / 8, true);
+}
@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "PoolContainers.hpp"
+
+namespace {
+
+constexpr long kEntries = 1 << 16;
+
+// Keys are inserted in shuffled order while unrelated heap allocations come
+// and go, which is how long-lived maps end up scattered across the heap.
+std::vector<long> shuffledKeys() {
+    std::vector<long> keys(kEntries);
+    std::uint64_t seed = 0x9E3779B97F4A7C15ull;
+    for (long i = 0; i < kEntries; ++i) {
+        keys[i] = i;
+    }
+    for (long i = kEntries - 1; i > 0; --i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        std::swap(keys[i], keys[seed % static_cast<std::uint64_t>(i + 1)]);
+    }
+    return keys;
+}
+
+template <typename Map>
+void fillWithHeapNoise(Map& map, const std::vector<long>& keys) {
+    std::vector<std::unique_ptr<char[]>> noise;
+    for (long key : keys) {
+        map.emplace(key, key);
+        noise.emplace_back(new char[48 + (key % 5) * 16]);
+    }
+}
+
+template <typename Map>
+void lookupLoop(BenchState& state, Map& map, const std::vector<long>& keys) {
+    long sum = 0;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        sum += map.find(keys[i % keys.size()])->second;
+    }
+    doNotOptimize(sum);
+}
+
+} // namespace
+
+BENCH(std_map_lookup) {
+    std::vector<long> keys = shuffledKeys();
+    std::map<long, long> map;
+    fillWithHeapNoise(map, keys);
+    state.resetTimer();
+    lookupLoop(state, map, keys);
+}
+
+BENCH(pool_map_lookup) {
+    std::vector<long> keys = shuffledKeys();
+    SizeClassedPool pools(kEntries);
+    pool_map<long, long> map(pools);
+    fillWithHeapNoise(map, keys);
+    state.resetTimer();
+    lookupLoop(state, map, keys);
+}
+
+BENCH(std_unordered_map_lookup) {
+    std::vector<long> keys = shuffledKeys();
+    std::unordered_map<long, long> map;
+    fillWithHeapNoise(map, keys);
+    state.resetTimer();
+    lookupLoop(state, map, keys);
+}
+
+BENCH(pool_unordered_map_lookup) {
+    std::vector<long> keys = shuffledKeys();
+    SizeClassedPool pools(kEntries);
+    pool_unordered_map<long, long> map(pools);
+    fillWithHeapNoise(map, keys);
+    state.resetTimer();
+    lookupLoop(state, map, keys);
+}
+
+BENCH(std_list_iterate) {
+    std::vector<long> keys = shuffledKeys();
+    std::list<long> list;
+    std::vector<std::unique_ptr<char[]>> noise;
+    for (long key : keys) {
+        list.push_back(key);
+        noise.emplace_back(new char[32]);
+    }
+    state.resetTimer();
+    long sum = 0;
+    for (std::size_t i = 0; i < state.iterations; i += kEntries) {
+        for (long value : list) {
+            sum += value;
+        }
+    }
+    doNotOptimize(sum);
+}
+
+BENCH(pool_list_iterate) {
+    std::vector<long> keys = shuffledKeys();
+    SizeClassedPool pools(kEntries);
+    pool_list<long> list(pools);
+    std::vector<std::unique_ptr<char[]>> noise;
+    for (long key : keys) {
+        list.push_back(key);
+        noise.emplace_back(new char[32]);
+    }
+    state.resetTimer();
+    long sum = 0;
+    for (std::size_t i = 0; i < state.iterations; i += kEntries) {
+        for (long value : list) {
+            sum += value;
+        }
+    }
+    doNotOptimize(sum);
+}
@@ -0,0 +1,70 @@
+#include <string>
+#include <string_view>
+
+#include "BenchHarness.hpp"
+#include "PoolString.hpp"
+
+namespace {
+
+constexpr std::string_view kFields[] = {"method=GET", " path=/api/v1/items", " status=200", " bytes=5120",
+                                        " agent=curl/8.4.0"};
+
+// Builds one log line of about 70 characters from its fields
+template <typename String>
+void appendLine(String& line) {
+    for (std::string_view field : kFields) {
+        line.append(field.data(), field.size());
+    }
+}
+
+} // namespace
+
+BENCH(std_string_log_line) {
+    std::size_t total = 0;
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        std::string line;
+        appendLine(line);
+        total += line.size();
+    }
+    doNotOptimize(total);
+}
+
+BENCH(pool_string_log_line) {
+    SizeClassedPool pools(64);
+    std::size_t total = 0;
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        pool_string line(pools);
+        appendLine(line);
+        total += line.size();
+    }
+    doNotOptimize(total);
+}
+
+// A request's worth of lines in one arena, reset per request
+BENCH(arena_string_log_line) {
+    constexpr std::size_t kLinesPerRequest = 32;
+    StringArena arena(4096, 16);
+    std::size_t total = 0;
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        if (i % kLinesPerRequest == 0) {
+            arena.reset();
+        }
+        arena_string line(arena);
+        appendLine(line);
+        total += line.size();
+    }
+    doNotOptimize(total);
+}
+
+BENCH(arena_intern_repeated_keys) {
+    StringArena arena;
+    std::size_t total = 0;
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        total += arena.intern(kFields[i % 5]).size();
+    }
+    doNotOptimize(total);
+}
@@ -0,0 +1,97 @@
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "MemoryPool.hpp"
+#include "MpmcRing.hpp"
+#include "SegmentQueue.hpp"
+
+namespace {
+
+// Work dispatch as it was: std::queue on the global heap behind one mutex
+class MutexQueue {
+private:
+    std::mutex mutex;
+    std::queue<std::size_t> items;
+
+public:
+    void push(std::size_t item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.push(item);
+    }
+
+    bool tryPop(std::size_t& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        item = items.front();
+        items.pop();
+        return true;
+    }
+};
+
+// Every thread alternates push and pop, so the depth stays near the thread
+// count; iterations is the total number of push/pop pairs. ns/op is the
+// cost of one pair as seen by the whole system.
+template <typename Queue, typename Push>
+void pushPop(BenchState& state, Queue& queue, unsigned threads, Push push) {
+    std::size_t perThread = state.iterations / threads + 1;
+    std::vector<std::thread> workers;
+    state.resetTimer();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&queue, &push, perThread] {
+            std::size_t item = 0;
+            for (std::size_t i = 0; i < perThread; ++i) {
+                push(queue, i);
+                while (!queue.tryPop(item)) {
+                    std::this_thread::yield();
+                }
+                doNotOptimize(item);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void mutexQueue(BenchState& state, unsigned threads) {
+    MutexQueue queue;
+    pushPop(state, queue, threads, [](MutexQueue& q, std::size_t item) { q.push(item); });
+}
+
+void ring(BenchState& state, unsigned threads) {
+    MpmcRing<std::size_t> queue(128);
+    pushPop(state, queue, threads, [](MpmcRing<std::size_t>& q, std::size_t item) {
+        while (!q.tryPush(item)) {
+            std::this_thread::yield();
+        }
+    });
+}
+
+void segmentQueue(BenchState& state, unsigned threads) {
+    using Queue = SegmentQueue<std::size_t, 64>;
+    MemoryPool pool(Queue::segmentBytes, 64);
+    Queue queue(pool);
+    pushPop(state, queue, threads, [](Queue& q, std::size_t item) { q.push(item); });
+}
+
+} // namespace
+
+BENCH(queue_mutex_std_queue_1_thread) { mutexQueue(state, 1); }
+BENCH(queue_mutex_std_queue_4_threads) { mutexQueue(state, 4); }
+BENCH(queue_mutex_std_queue_16_threads) { mutexQueue(state, 16); }
+BENCH(queue_mutex_std_queue_64_threads) { mutexQueue(state, 64); }
+
+BENCH(queue_mpmc_ring_1_thread) { ring(state, 1); }
+BENCH(queue_mpmc_ring_4_threads) { ring(state, 4); }
+BENCH(queue_mpmc_ring_16_threads) { ring(state, 16); }
+BENCH(queue_mpmc_ring_64_threads) { ring(state, 64); }
+
+BENCH(queue_segment_1_thread) { segmentQueue(state, 1); }
+BENCH(queue_segment_4_threads) { segmentQueue(state, 4); }
+BENCH(queue_segment_16_threads) { segmentQueue(state, 16); }
+BENCH(queue_segment_64_threads) { segmentQueue(state, 64); }
@@ -0,0 +1,83 @@
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "BenchHarness.hpp"
+#include "EpochDomain.hpp"
+#include "HazardDomain.hpp"
+#include "MemoryPool.hpp"
+
+namespace {
+
+constexpr std::size_t kUpdateEvery = 16; // Read-mostly: one replacement per 16 reads
+
+struct Config {
+    std::uint64_t version;
+    std::uint64_t limit;
+};
+
+} // namespace
+
+// Baseline: readers and writers share one mutex around the pool and the pointer
+BENCH(reclamation_mutex_read_mostly) {
+    MemoryPool pool(sizeof(Config), 4);
+    std::mutex mutex;
+    Config* current = new (pool.allocate()) Config{0, 100};
+    state.resetTimer();
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sum += current->limit;
+        }
+        if (i % kUpdateEvery == 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            Config* next = new (pool.allocate()) Config{i, current->limit + 1};
+            pool.deallocate(current);
+            current = next;
+        }
+    }
+    doNotOptimize(sum);
+    pool.deallocate(current);
+}
+
+BENCH(reclamation_epoch_read_mostly) {
+    MemoryPool pool(sizeof(Config), 256);
+    EpochDomain<> domain(pool);
+    std::atomic<Config*> current{new (domain.allocate()) Config{0, 100}};
+    state.resetTimer();
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        {
+            auto guard = domain.pin();
+            sum += current.load(std::memory_order_acquire)->limit;
+        }
+        if (i % kUpdateEvery == 0) {
+            Config* next = new (domain.allocate()) Config{i, current.load()->limit + 1};
+            domain.retire(static_cast<void*>(current.exchange(next, std::memory_order_acq_rel)));
+        }
+    }
+    doNotOptimize(sum);
+    domain.retire(static_cast<void*>(current.load()));
+}
+
+// protect() costs a compiler barrier when membarrier is available; the
+// writer pays one membarrier per scan of the bounded retired list
+BENCH(reclamation_hazard_read_mostly) {
+    MemoryPool pool(sizeof(Config), 256);
+    HazardDomain<> domain(pool);
+    std::atomic<Config*> current{new (domain.allocate()) Config{0, 100}};
+    auto hazard = domain.makeHazard();
+    state.resetTimer();
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        sum += hazard.protect(current)->limit;
+        hazard.reset();
+        if (i % kUpdateEvery == 0) {
+            Config* next = new (domain.allocate()) Config{i, current.load()->limit + 1};
+            domain.retire(static_cast<void*>(current.exchange(next, std::memory_order_acq_rel)));
+        }
+    }
+    doNotOptimize(sum);
+    domain.retire(static_cast<void*>(current.load()));
+}
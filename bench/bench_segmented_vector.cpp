@@ -0,0 +1,58 @@
+#include <cstddef>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "SegmentedVector.hpp"
+
+namespace {
+
+// Elements appended per measured build
+constexpr std::size_t kElements = 1024;
+
+struct Record {
+    std::size_t id;
+    double values[3];
+};
+
+} // namespace
+
+BENCH(std_vector_append) {
+    std::size_t total = 0;
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; i += kElements) {
+        std::vector<Record> records;
+        for (std::size_t j = 0; j < kElements; ++j) {
+            records.push_back(Record{j, {1.0, 2.0, 3.0}});
+        }
+        total += records.back().id;
+    }
+    doNotOptimize(total);
+}
+
+BENCH(segmented_vector_append) {
+    MemoryPool pool(4096, 64);
+    std::size_t total = 0;
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; i += kElements) {
+        SegmentedVector<Record> records(pool);
+        for (std::size_t j = 0; j < kElements; ++j) {
+            records.push_back(Record{j, {1.0, 2.0, 3.0}});
+        }
+        total += records.back().id;
+    }
+    doNotOptimize(total);
+}
+
+BENCH(segmented_vector_random_access) {
+    MemoryPool pool(4096, 64);
+    SegmentedVector<Record> records(pool);
+    for (std::size_t j = 0; j < kElements; ++j) {
+        records.push_back(Record{j, {1.0, 2.0, 3.0}});
+    }
+    std::size_t total = 0;
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        total += records[(i * 7) & (kElements - 1)].id;
+    }
+    doNotOptimize(total);
+}
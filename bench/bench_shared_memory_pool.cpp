@@ -0,0 +1,23 @@
+#include "BenchHarness.hpp"
+#include "SharedMemoryPool.hpp"
+
+namespace {
+
+constexpr std::size_t kBatch = 64;
+
+} // namespace
+
+// Cost of the process-shared robust mutex compared with pool_allocate_deallocate_batch
+BENCH(shared_pool_allocate_deallocate_batch) {
+    SharedMemoryPool pool(64, kBatch);
+    void* blocks[kBatch];
+    for (std::size_t i = 0; i < state.iterations; i += kBatch) {
+        for (void*& block : blocks) {
+            block = pool.allocate();
+        }
+        doNotOptimize(blocks);
+        for (void* block : blocks) {
+            pool.deallocate(block);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "PoolAllocator.hpp"
+#include "SmallVector.hpp"
+
+namespace {
+
+// Most vectors hold a handful of elements; kLarge spills past the inline storage
+constexpr int kSmall = 5;
+constexpr int kLarge = 20;
+
+template <typename Vector, typename Make>
+void buildAndSum(BenchState& state, int elements, Make make) {
+    long sum = 0;
+    state.resetTimer();
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        Vector vector = make();
+        for (int e = 0; e < elements; ++e) {
+            vector.push_back(e);
+        }
+        for (int value : vector) {
+            sum += value;
+        }
+        doNotOptimize(sum);
+    }
+}
+
+} // namespace
+
+BENCH(std_vector_small) {
+    buildAndSum<std::vector<int>>(state, kSmall, [] { return std::vector<int>(); });
+}
+
+// One pool block per growth step instead of one malloc
+BENCH(pool_vector_small) {
+    SizeClassedPool pools(64);
+    using Vector = std::vector<int, PoolAllocator<int>>;
+    buildAndSum<Vector>(state, kSmall, [&] { return Vector(PoolAllocator<int>(pools)); });
+}
+
+BENCH(small_vector_small) {
+    SizeClassedPool pools(64);
+    using Vector = small_vector<int, 8>;
+    buildAndSum<Vector>(state, kSmall, [&] { return Vector(pools); });
+}
+
+BENCH(std_vector_spilled) {
+    buildAndSum<std::vector<int>>(state, kLarge, [] { return std::vector<int>(); });
+}
+
+BENCH(small_vector_spilled) {
+    SizeClassedPool pools(64);
+    using Vector = small_vector<int, 8>;
+    buildAndSum<Vector>(state, kLarge, [&] { return Vector(pools); });
+}
@@ -0,0 +1,74 @@
+#include <mutex>
+#include <thread>
+
+#include "BenchHarness.hpp"
+#include "MemoryPool.hpp"
+#include "MpmcRing.hpp"
+#include "ThreadHeapPool.hpp"
+
+namespace {
+
+// One thread allocates and hands blocks over a ring, another frees them
+template <typename Allocate, typename Free>
+void pipeline(BenchState& state, Allocate allocate, Free free) {
+    MpmcRing<void*> ring(256);
+    state.resetTimer();
+    std::thread consumer([&] {
+        void* block;
+        for (std::size_t i = 0; i < state.iterations; ++i) {
+            while (!ring.tryPop(block)) {
+                std::this_thread::yield();
+            }
+            free(block);
+        }
+    });
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        void* block = allocate();
+        while (!ring.tryPush(block)) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+}
+
+} // namespace
+
+// Baseline: both ends share one free list behind a mutex
+BENCH(pipeline_mutex_pool) {
+    MemoryPool pool(64, 1024);
+    std::mutex mutex;
+    pipeline(
+        state,
+        [&] {
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (pool.hasAvailableMemory()) {
+                        return pool.allocate();
+                    }
+                }
+                std::this_thread::yield();
+            }
+        },
+        [&](void* block) {
+            std::lock_guard<std::mutex> lock(mutex);
+            pool.deallocate(block);
+        });
+}
+
+// Frees are one atomic push; the producer drains them in batches
+BENCH(pipeline_thread_heap_pool) {
+    ThreadHeapPool pool(64, 1024);
+    pipeline(
+        state,
+        [&] {
+            while (true) {
+                try {
+                    return pool.allocate();
+                } catch (const std::bad_alloc&) {
+                    std::this_thread::yield(); // Every block is in flight
+                }
+            }
+        },
+        [&](void* block) { pool.deallocate(block); });
+}
@@ -0,0 +1,41 @@
+#include <atomic>
+#include <functional>
+
+#include "BenchHarness.hpp"
+#include "WorkStealingScheduler.hpp"
+
+namespace {
+
+// Binary fork tree with `count` leaves; every spawn is one task block
+void forkTree(WorkStealingScheduler& scheduler, std::size_t count, std::atomic<std::size_t>& leaves) {
+    if (count <= 1) {
+        leaves.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    scheduler.spawn([&scheduler, count, &leaves] { forkTree(scheduler, count / 2, leaves); });
+    scheduler.spawn([&scheduler, count, &leaves] { forkTree(scheduler, count - count / 2, leaves); });
+}
+
+} // namespace
+
+// Spawn, run and free of pool-allocated tasks; iterations is the leaf count
+BENCH(work_stealing_fork_tree) {
+    WorkStealingScheduler scheduler(4);
+    std::atomic<std::size_t> leaves{0};
+    state.resetTimer();
+    scheduler.spawn([&] { forkTree(scheduler, state.iterations, leaves); });
+    scheduler.wait();
+    doNotOptimize(leaves.load());
+}
+
+// What a task system that heap-allocates each closure pays per task
+BENCH(heap_closure_task) {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+        auto* task = new std::function<void()>([&sum, i] { sum += i; });
+        doNotOptimize(task);
+        (*task)();
+        delete task;
+    }
+    doNotOptimize(sum);
+}
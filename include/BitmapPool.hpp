@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__AVX2__) && !defined(MPM_BITMAP_POOL_PORTABLE)
+#include <immintrin.h>
+#endif
+
+namespace bitmap_pool_detail {
+
+// Index of the first non-zero word in [from, count), or count
+inline std::size_t findNonZero(const std::uint64_t* words, std::size_t from, std::size_t count) {
+#if defined(__AVX2__) && !defined(MPM_BITMAP_POOL_PORTABLE)
+    for (; from + 4 <= count; from += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + from));
+        if (!_mm256_testz_si256(v, v)) {
+            __m256i zero = _mm256_cmpeq_epi64(v, _mm256_setzero_si256());
+            unsigned nonZero = ~static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(zero))) & 0xFu;
+            return from + static_cast<std::size_t>(__builtin_ctz(nonZero));
+        }
+    }
+#endif
+    for (; from < count; ++from) {
+        if (words[from] != 0) {
+            return from;
+        }
+    }
+    return count;
+}
+
+inline std::size_t lowestBit(std::uint64_t word) {
+    return static_cast<std::size_t>(__builtin_ctzll(word)); // tzcnt when BMI is enabled
+}
+
+} // namespace bitmap_pool_detail
+
+// Fixed-size block pool that always hands out the lowest free block. Free
+// blocks are tracked out of band in a two-level bitmap: one bit per block,
+// and one summary bit per 64-block word that still has a free block. An
+// allocation finds the first non-zero summary word (four words per AVX2
+// compare when available), then takes the lowest set bits with tzcnt; the
+// search starts from a hint that only moves down on deallocate, so the
+// amortized cost is constant. Live objects stay packed at the start of the
+// slab, and since free blocks are never written to, trim() can hand the
+// free tail back to the kernel. Like MemoryPool, it is meant for use from
+// one thread.
+class BitmapPool {
+private:
+    unsigned char* slab = nullptr;
+    std::size_t blockSize;
+    std::size_t stride;
+    std::size_t capacity;
+    std::size_t slabBytes;
+    std::size_t freeCount;
+    std::vector<std::uint64_t> freeBits; // Bit set: block free
+    std::vector<std::uint64_t> summary; // Bit set: freeBits word has a free block
+    std::size_t searchStart = 0; // No summary word below this one is non-zero
+
+    static std::size_t pageSize() {
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+public:
+    BitmapPool(std::size_t blockSize, std::size_t capacity)
+        : blockSize(blockSize),
+          stride((blockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t)),
+          capacity(capacity),
+          freeCount(capacity),
+          freeBits((capacity + 63) / 64, ~std::uint64_t(0)),
+          summary((freeBits.size() + 63) / 64, ~std::uint64_t(0)) {
+        if (blockSize == 0 || capacity == 0) {
+            throw std::invalid_argument("BitmapPool: blockSize and capacity must be non-zero");
+        }
+        // Bits past the last block are never free
+        if (capacity % 64 != 0) {
+            freeBits.back() = (std::uint64_t(1) << (capacity % 64)) - 1;
+        }
+        if (freeBits.size() % 64 != 0) {
+            summary.back() = (std::uint64_t(1) << (freeBits.size() % 64)) - 1;
+        }
+        slabBytes = (stride * capacity + pageSize() - 1) / pageSize() * pageSize();
+        void* memory = ::mmap(nullptr, slabBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        slab = static_cast<unsigned char*>(memory);
+    }
+
+    ~BitmapPool() {
+        ::munmap(slab, slabBytes);
+    }
+
+    BitmapPool(const BitmapPool&) = delete;
+    BitmapPool& operator=(const BitmapPool&) = delete;
+
+    void* allocate() {
+        if (freeCount == 0) {
+            throw std::bad_alloc();
+        }
+        std::size_t top = bitmap_pool_detail::findNonZero(summary.data(), searchStart, summary.size());
+        searchStart = top;
+        std::size_t word = top * 64 + bitmap_pool_detail::lowestBit(summary[top]);
+        std::size_t bit = bitmap_pool_detail::lowestBit(freeBits[word]);
+        freeBits[word] &= freeBits[word] - 1; // Clear the lowest set bit
+        if (freeBits[word] == 0) {
+            summary[top] &= ~(std::uint64_t(1) << (word % 64));
+        }
+        --freeCount;
+        return slab + (word * 64 + bit) * stride;
+    }
+
+    void deallocate(void* block) {
+        std::size_t index = blockIndex(block);
+        std::size_t word = index / 64;
+        freeBits[word] |= std::uint64_t(1) << (index % 64);
+        summary[word / 64] |= std::uint64_t(1) << (word % 64);
+        if (word / 64 < searchStart) {
+            searchStart = word / 64;
+        }
+        ++freeCount;
+    }
+
+    // Returns the pages past the highest live block to the kernel; they read
+    // back as zeros when reused. Returns the number of bytes released.
+    std::size_t trim() {
+        std::size_t end = 0; // One past the highest live block
+        for (std::size_t word = freeBits.size(); word > 0; --word) {
+            std::uint64_t valid = word * 64 <= capacity ? ~std::uint64_t(0)
+                                                        : (std::uint64_t(1) << (capacity % 64)) - 1;
+            std::uint64_t live = ~freeBits[word - 1] & valid;
+            if (live != 0) {
+                end = (word - 1) * 64 + 63 - static_cast<std::size_t>(__builtin_clzll(live)) + 1;
+                break;
+            }
+        }
+        std::size_t from = (end * stride + pageSize() - 1) / pageSize() * pageSize();
+        if (from >= slabBytes) {
+            return 0;
+        }
+        ::madvise(slab + from, slabBytes - from, MADV_DONTNEED);
+        return slabBytes - from;
+    }
+
+    bool hasAvailableMemory() const {
+        return freeCount != 0;
+    }
+
+    std::size_t getBlockSize() const {
+        return blockSize;
+    }
+
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+
+    std::size_t getAvailableCount() const {
+        return freeCount;
+    }
+
+    bool owns(const void* block) const {
+        auto address = static_cast<const unsigned char*>(block);
+        return address >= slab && address < slab + stride * capacity;
+    }
+
+    std::size_t blockIndex(const void* block) const {
+        return static_cast<std::size_t>(static_cast<const unsigned char*>(block) - slab) / stride;
+    }
+
+    bool isFree(std::size_t index) const {
+        return (freeBits[index / 64] >> (index % 64) & 1) != 0;
+    }
+};
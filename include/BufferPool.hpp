@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "MemoryPool.hpp"
+
+class BufferPool;
+class Buffer;
+
+// Bookkeeping for one pooled buffer. Kept outside the buffer so the whole
+// page-aligned block stays available for I/O.
+struct BufferControl {
+    BufferPool* pool;
+    unsigned char* data;
+    std::size_t refs;
+};
+
+// Pool of fixed-size, page-aligned I/O buffers with refcounted handles.
+// A Buffer owns a whole block; BufferSlices are cheap views that share the
+// block's refcount, so a parser can keep slices of the read buffer instead of
+// copying payloads out of it. The block returns to the pool when the last
+// handle goes away. Like MemoryPool, it is meant for use from one thread.
+class BufferPool {
+private:
+    friend class BufferHandle;
+
+    MemoryPool buffers;
+    MemoryPool controls;
+    std::size_t bufferSize;
+
+    static std::size_t pageSize() {
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    void release(BufferControl* control) {
+        buffers.deallocate(control->data);
+        controls.deallocate(control);
+    }
+
+public:
+    // bufferSize is rounded up to a whole number of pages
+    BufferPool(std::size_t bufferSize, std::size_t bufferCount)
+        : buffers((bufferSize + pageSize() - 1) / pageSize() * pageSize(), bufferCount, pageSize()),
+          controls(sizeof(BufferControl), bufferCount),
+          bufferSize((bufferSize + pageSize() - 1) / pageSize() * pageSize()) {
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    Buffer acquire();
+
+    std::size_t getBufferSize() const {
+        return bufferSize;
+    }
+
+    std::size_t getAvailableCount() const {
+        return buffers.getAvailableCount();
+    }
+};
+
+// Shared ownership of one pooled block
+class BufferHandle {
+protected:
+    BufferControl* control = nullptr;
+
+    explicit BufferHandle(BufferControl* control) : control(control) {}
+
+    void retain() {
+        if (control != nullptr) {
+            ++control->refs;
+        }
+    }
+
+    void reset() {
+        if (control != nullptr && --control->refs == 0) {
+            control->pool->release(control);
+        }
+        control = nullptr;
+    }
+
+public:
+    BufferHandle() = default;
+
+    BufferHandle(const BufferHandle& other) : control(other.control) {
+        retain();
+    }
+
+    BufferHandle(BufferHandle&& other) noexcept : control(std::exchange(other.control, nullptr)) {}
+
+    BufferHandle& operator=(const BufferHandle& other) {
+        if (control != other.control) {
+            reset();
+            control = other.control;
+            retain();
+        }
+        return *this;
+    }
+
+    BufferHandle& operator=(BufferHandle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            control = std::exchange(other.control, nullptr);
+        }
+        return *this;
+    }
+
+    ~BufferHandle() {
+        reset();
+    }
+
+    explicit operator bool() const {
+        return control != nullptr;
+    }
+
+    // Handles (buffers and slices) currently sharing the block
+    std::size_t useCount() const {
+        return control != nullptr ? control->refs : 0;
+    }
+};
+
+// Read-only view of part of a pooled buffer; keeps the buffer alive
+class BufferSlice : public BufferHandle {
+private:
+    friend class Buffer;
+
+    const unsigned char* begin = nullptr;
+    std::size_t length = 0;
+
+    BufferSlice(BufferControl* control, const unsigned char* begin, std::size_t length)
+        : BufferHandle(control), begin(begin), length(length) {
+        retain();
+    }
+
+public:
+    BufferSlice() = default;
+
+    const unsigned char* data() const {
+        return begin;
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+
+    bool empty() const {
+        return length == 0;
+    }
+
+    std::string_view view() const {
+        return std::string_view(reinterpret_cast<const char*>(begin), length);
+    }
+
+    // Narrower view of the same block; no bytes are copied
+    BufferSlice slice(std::size_t offset, std::size_t count) const {
+        if (offset > length || count > length - offset) {
+            throw std::out_of_range("BufferSlice::slice");
+        }
+        return BufferSlice(control, begin + offset, count);
+    }
+
+    iovec toIovec() const {
+        return iovec{const_cast<unsigned char*>(begin), length};
+    }
+};
+
+// Writable handle to a whole pooled buffer. size() counts the bytes filled
+// so far, e.g. by a read; slices can only be taken from that filled prefix.
+class Buffer : public BufferHandle {
+private:
+    friend class BufferPool;
+
+    std::size_t filled = 0;
+
+    explicit Buffer(BufferControl* control) : BufferHandle(control) {}
+
+public:
+    Buffer() = default;
+
+    unsigned char* data() const {
+        return control->data;
+    }
+
+    std::size_t capacity() const {
+        return control->pool->getBufferSize();
+    }
+
+    std::size_t size() const {
+        return filled;
+    }
+
+    void setSize(std::size_t bytes) {
+        if (bytes > capacity()) {
+            throw std::out_of_range("Buffer::setSize");
+        }
+        filled = bytes;
+    }
+
+    BufferSlice slice(std::size_t offset, std::size_t count) const {
+        if (offset > filled || count > filled - offset) {
+            throw std::out_of_range("Buffer::slice");
+        }
+        return BufferSlice(control, control->data + offset, count);
+    }
+
+    BufferSlice filledSlice() const {
+        return slice(0, filled);
+    }
+
+    // Unfilled tail, for reading more data in
+    iovec spareIovec() const {
+        return iovec{control->data + filled, capacity() - filled};
+    }
+};
+
+inline Buffer BufferPool::acquire() {
+    void* memory = controls.allocate();
+    void* data;
+    try {
+        data = buffers.allocate();
+    } catch (...) {
+        controls.deallocate(memory);
+        throw;
+    }
+    auto* control = new (memory) BufferControl{this, static_cast<unsigned char*>(data), 1};
+    return Buffer(control);
+}
+
+// Scatter read into the spare space of the given buffers, in order; grows
+// each buffer's size() by the bytes it received. Returns readv's result.
+inline ssize_t readInto(int fd, Buffer* buffers, std::size_t count) {
+    constexpr std::size_t maxIovecs = 64;
+    iovec iov[maxIovecs];
+    std::size_t used = count < maxIovecs ? count : maxIovecs;
+    for (std::size_t i = 0; i < used; ++i) {
+        iov[i] = buffers[i].spareIovec();
+    }
+    ssize_t received = ::readv(fd, iov, static_cast<int>(used));
+    std::size_t remaining = received > 0 ? static_cast<std::size_t>(received) : 0;
+    for (std::size_t i = 0; i < used && remaining > 0; ++i) {
+        std::size_t taken = remaining < iov[i].iov_len ? remaining : iov[i].iov_len;
+        buffers[i].setSize(buffers[i].size() + taken);
+        remaining -= taken;
+    }
+    return received;
+}
+
+// Gather write of slices, in order, without copying them into one buffer
+inline ssize_t writeFrom(int fd, const BufferSlice* slices, std::size_t count) {
+    constexpr std::size_t maxIovecs = 64;
+    iovec iov[maxIovecs];
+    std::size_t used = count < maxIovecs ? count : maxIovecs;
+    for (std::size_t i = 0; i < used; ++i) {
+        iov[i] = slices[i].toIovec();
+    }
+    return ::writev(fd, iov, static_cast<int>(used));
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new> // For std::bad_alloc
+
+#include "SizeClassedPool.hpp"
+
+// Per-thread recycling of coroutine frames by size class. Frames are plain
+// malloc blocks, which is also what heap-mode MemoryPools hold, so a frame
+// may be freed on a different thread than the one that created it: it simply
+// joins that thread's pool for its size class. A dry class grows by a whole
+// chunk of frames, doubling up to maxRetainedPerClass, and a class never
+// keeps more idle frames than its capacity, so freeing a frame never grows
+// the pool's free list; frames beyond it go back to malloc.
+class CoroutineFramePool {
+public:
+    static constexpr std::size_t initialBlocksPerClass = 32;
+    static constexpr std::size_t maxPooledFrame = 4096;
+    static constexpr std::size_t maxRetainedPerClass = 1024;
+
+private:
+    struct LocalPools {
+        SizeClassedPool pools{initialBlocksPerClass, maxPooledFrame};
+
+        ~LocalPools() {
+            destroyed() = true;
+        }
+    };
+
+    // Set once this thread's pools are gone, for frames freed during thread teardown
+    static bool& destroyed() {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    static SizeClassedPool& local() {
+        static thread_local LocalPools pools;
+        return pools.pools;
+    }
+
+public:
+    static void* allocate(std::size_t size) {
+        if (size > maxPooledFrame) {
+            return ::operator new(size);
+        }
+        if (!destroyed()) {
+            MemoryPool& pool = local().poolFor(size);
+            if (!pool.hasAvailableMemory() && pool.getCapacity() < maxRetainedPerClass) {
+                pool.grow(std::min(pool.getCapacity(), maxRetainedPerClass - pool.getCapacity()));
+            }
+            if (pool.hasAvailableMemory()) {
+                return pool.allocate();
+            }
+        }
+        // Class is at its limit: a lone frame, sized for the whole class
+        void* frame = std::malloc(SizeClassedPool::roundUp(size));
+        if (frame == nullptr) {
+            throw std::bad_alloc();
+        }
+        return frame;
+    }
+
+    static void deallocate(void* frame, std::size_t size) {
+        if (size > maxPooledFrame) {
+            ::operator delete(frame);
+            return;
+        }
+        if (destroyed()) {
+            std::free(frame);
+            return;
+        }
+        MemoryPool& pool = local().poolFor(size);
+        if (pool.getAvailableCount() >= pool.getCapacity()) {
+            // No room reserved for it, e.g. a frame from another thread
+            std::free(frame);
+            return;
+        }
+        pool.deallocate(frame);
+    }
+
+    // Idle frames cached on this thread for the class serving size
+    static std::size_t idleFrames(std::size_t size) {
+        return size > maxPooledFrame || destroyed() ? 0 : local().poolFor(size).getAvailableCount();
+    }
+};
+
+// Promise-type mixin: derive a coroutine's promise_type from it and the
+// compiler allocates that coroutine's frames through CoroutineFramePool.
+//
+//     struct Task { struct promise_type : PoolAllocatedFrame { ... }; };
+struct PoolAllocatedFrame {
+    static void* operator new(std::size_t size) {
+        return CoroutineFramePool::allocate(size);
+    }
+
+    static void operator delete(void* frame, std::size_t size) {
+        CoroutineFramePool::deallocate(frame, size);
+    }
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new> // For std::bad_alloc
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ThreadRegistry.hpp"
+
+namespace deferred_detail {
+
+// One object waiting for its destructor and for its block to go back to the pool
+struct Retired {
+    void* object;
+    void* pool;
+    void (*destroy)(void* object, void* pool);
+};
+
+template <typename T, typename Pool>
+void destroyAndFree(void* object, void* pool) {
+    static_cast<T*>(object)->~T();
+    static_cast<Pool*>(pool)->deallocate(object);
+}
+
+} // namespace deferred_detail
+
+// Takes object teardown off latency-critical threads. The deleter of a
+// deferred object only appends it to a per-thread batch; full batches are
+// handed to the destroyer under one lock, and drain() later runs the
+// destructors and returns the blocks to their pools in bulk, either at a
+// quiescent point of the caller's choosing or on a background worker.
+// Objects whose destructors release further deferred objects (an object
+// graph) are torn down in the same drain. The worker frees blocks from its
+// own thread, so only use it with pools that allow that, e.g. a PoolManager
+// with a thread cache; for single-threaded pools, call drain() from the
+// pool's thread.
+class DeferredDestroyer {
+private:
+    using Batch = std::vector<deferred_detail::Retired>;
+    using Registry = ThreadRegistry<DeferredDestroyer, Batch>;
+    friend Registry;
+
+    std::uint64_t id;
+    std::size_t batchSize;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::vector<deferred_detail::Retired>> handedOff; // Guarded by mutex
+    bool stopping = false; // Guarded by mutex
+    std::thread worker;
+    std::atomic<std::size_t> destroyedCount{0};
+
+    std::vector<deferred_detail::Retired>& localBatch() {
+        if (Batch* batch = Registry::find(id)) {
+            return *batch;
+        }
+        Batch batch;
+        batch.reserve(batchSize);
+        return Registry::attach(id, this, std::move(batch));
+    }
+
+    // Thread exit: hands the leftover batch over
+    void detachThread(Batch& batch) {
+        if (!batch.empty()) {
+            handOff(std::move(batch));
+        }
+    }
+
+    void handOff(std::vector<deferred_detail::Retired>&& entries) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            handedOff.push_back(std::move(entries));
+        }
+        wake.notify_one();
+    }
+
+    static std::size_t destroyAll(std::vector<deferred_detail::Retired>& entries) {
+        for (const deferred_detail::Retired& entry : entries) {
+            entry.destroy(entry.object, entry.pool);
+        }
+        std::size_t count = entries.size();
+        entries.clear();
+        return count;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !handedOff.empty(); });
+            if (handedOff.empty()) {
+                return; // Stopping with nothing left
+            }
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+public:
+    explicit DeferredDestroyer(std::size_t batchSize = 64)
+        : id(Registry::registerOwner()), batchSize(batchSize > 0 ? batchSize : 1) {
+    }
+
+    // Stops the worker and destroys everything handed off or retired on this
+    // thread. Batches other threads still hold are lost, so those threads
+    // should flush() or exit first.
+    ~DeferredDestroyer() {
+        stopWorker();
+        Registry::unregisterOwner(id);
+        drain();
+        Registry::forget(id);
+    }
+
+    DeferredDestroyer(const DeferredDestroyer&) = delete;
+    DeferredDestroyer& operator=(const DeferredDestroyer&) = delete;
+
+    // Deleter side: queues the object; nothing is destroyed or freed here
+    template <typename T, typename Pool>
+    void retire(T* object, Pool& pool) {
+        std::vector<deferred_detail::Retired>& batch = localBatch();
+        batch.push_back(deferred_detail::Retired{object, &pool, &deferred_detail::destroyAndFree<T, Pool>});
+        if (batch.size() >= batchSize) {
+            std::vector<deferred_detail::Retired> full;
+            full.reserve(batchSize);
+            full.swap(batch);
+            handOff(std::move(full));
+        }
+    }
+
+    // Hands this thread's partial batch over
+    void flush() {
+        std::vector<deferred_detail::Retired>& batch = localBatch();
+        if (!batch.empty()) {
+            std::vector<deferred_detail::Retired> partial;
+            partial.swap(batch);
+            handOff(std::move(partial));
+        }
+    }
+
+    // Destroys and frees everything handed off so far plus this thread's
+    // batch, including objects released by those destructors. Returns the
+    // number of objects destroyed.
+    std::size_t drain() {
+        std::size_t destroyed = 0;
+        std::vector<deferred_detail::Retired> current;
+        while (true) {
+            std::vector<std::vector<deferred_detail::Retired>> batches;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                batches.swap(handedOff);
+            }
+            current.swap(localBatch());
+            if (batches.empty() && current.empty()) {
+                break;
+            }
+            destroyed += destroyAll(current);
+            for (std::vector<deferred_detail::Retired>& batch : batches) {
+                destroyed += destroyAll(batch);
+            }
+        }
+        destroyedCount.fetch_add(destroyed, std::memory_order_relaxed);
+        return destroyed;
+    }
+
+    // Background worker that drains each batch as it is handed off
+    void startWorker() {
+        if (!worker.joinable()) {
+            stopping = false;
+            worker = std::thread([this] { run(); });
+        }
+    }
+
+    // Drains what was handed off, then joins the worker
+    void stopWorker() {
+        if (!worker.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    std::size_t getBatchSize() const {
+        return batchSize;
+    }
+
+    // Objects destroyed so far by drain(), on any thread
+    std::size_t getDestroyedCount() const {
+        return destroyedCount.load(std::memory_order_relaxed);
+    }
+};
+
+// make_unique_pool whose deleter defers teardown to a DeferredDestroyer. The
+// pool and the destroyer must outlive the object's final drain.
+template <typename T, typename Pool, typename... Args>
+std::unique_ptr<T, std::function<void(T*)>> make_unique_deferred(Pool& pool, DeferredDestroyer& destroyer,
+                                                                 Args&&... args) {
+    // An object must fit in a single block
+    if (sizeof(T) > pool.getBlockSize()) {
+        throw std::bad_alloc();
+    }
+    void* memory = pool.allocate();
+    T* ptr;
+    try {
+        ptr = new (memory) T(std::forward<Args>(args)...);
+    } catch (...) {
+        pool.deallocate(memory); // Constructor threw, hand the block back
+        throw;
+    }
+    return std::unique_ptr<T, std::function<void(T*)>>(
+        ptr, [&pool, &destroyer](T* object) { destroyer.retire(object, pool); });
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "MemoryPool.hpp"
+#include "ThreadRegistry.hpp"
+
+namespace epoch_detail {
+
+// A block waiting for a grace period; destroy runs the object's destructor
+struct Retired {
+    void* block;
+    void (*destroy)(void* block);
+};
+
+template <typename T>
+void destroyObject(void* block) {
+    static_cast<T*>(block)->~T();
+}
+
+// Blocks retired during one epoch
+struct Bucket {
+    std::uint64_t epoch = 0;
+    std::vector<Retired> blocks;
+};
+
+// Per-thread participation in one domain. Records are reused by later
+// threads and only freed with the domain.
+struct alignas(64) Record {
+    std::atomic<std::uint64_t> state{0}; // (epoch << 1) | 1 while pinned, 0 otherwise
+    std::atomic<bool> inUse{true};
+    Record* next = nullptr;
+    unsigned nesting = 0;
+    std::size_t retiredSinceScan = 0;
+    Bucket buckets[3]; // Indexed by epoch % 3
+};
+
+} // namespace epoch_detail
+
+// Epoch-based reclamation for lock-free structures whose nodes come from a
+// pool. Readers pin() the domain while they may hold node pointers; writers
+// retire() a node once it is unlinked, and the node's block goes back to the
+// pool only after every thread pinned at the time has unpinned. A global
+// epoch advances when all pinned threads have observed it; blocks retired in
+// epoch e are reclaimed once the epoch reaches e + 2. Pinning costs one store
+// and one fence; blocks are returned to the pool in batches under the lock
+// that also serializes allocate(). A thread that stays pinned holds up
+// reclamation for everyone, so keep guards short.
+template <typename Pool = MemoryPool>
+class EpochDomain {
+public:
+    // Keeps the calling thread pinned for its lifetime; guards nest
+    class Guard {
+    private:
+        friend class EpochDomain;
+
+        EpochDomain* domain;
+        epoch_detail::Record* record;
+
+        Guard(EpochDomain* domain, epoch_detail::Record* record) : domain(domain), record(record) {}
+
+    public:
+        Guard(Guard&& other) noexcept
+            : domain(std::exchange(other.domain, nullptr)), record(std::exchange(other.record, nullptr)) {}
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+        ~Guard() {
+            if (record != nullptr && --record->nesting == 0) {
+                record->state.store(0, std::memory_order_release);
+            }
+        }
+    };
+
+private:
+    using Registry = ThreadRegistry<EpochDomain, epoch_detail::Record*>;
+    friend Registry;
+
+    Pool& pool;
+    std::uint64_t id;
+    std::size_t scanThreshold;
+    std::mutex poolMutex;
+    alignas(64) std::atomic<std::uint64_t> globalEpoch{2}; // Starts at 2 so e - 2 never wraps
+    std::atomic<epoch_detail::Record*> records{nullptr};
+    std::mutex orphanMutex;
+    std::vector<epoch_detail::Bucket> orphans; // Left by exited threads, guarded by orphanMutex
+    std::atomic<std::size_t> reclaimedCount{0};
+
+    epoch_detail::Record* acquireRecord() {
+        for (epoch_detail::Record* record = records.load(std::memory_order_acquire); record != nullptr;
+             record = record->next) {
+            bool expected = false;
+            if (!record->inUse.load(std::memory_order_relaxed) &&
+                record->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return record;
+            }
+        }
+        auto* record = new epoch_detail::Record();
+        epoch_detail::Record* head = records.load(std::memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+        return record;
+    }
+
+    epoch_detail::Record* localRecord() {
+        if (epoch_detail::Record** record = Registry::find(id)) {
+            return *record;
+        }
+        return Registry::attach(id, this, acquireRecord());
+    }
+
+    // Thread exit: pending blocks move to the orphan list, where any thread's
+    // collect() reclaims them once their grace period is over
+    void detachThread(epoch_detail::Record* record) {
+        {
+            std::lock_guard<std::mutex> lock(orphanMutex);
+            for (epoch_detail::Bucket& bucket : record->buckets) {
+                if (!bucket.blocks.empty()) {
+                    orphans.push_back(std::move(bucket));
+                    bucket.blocks.clear();
+                }
+            }
+        }
+        record->nesting = 0;
+        record->retiredSinceScan = 0;
+        record->state.store(0, std::memory_order_release);
+        record->inUse.store(false, std::memory_order_release);
+    }
+
+    // Advances the global epoch if every pinned thread has observed it
+    bool tryAdvance() {
+        std::uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+        // Pairs with the fence in pin(): a reader either shows up pinned in
+        // the scan below or reads shared nodes only after this point
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (epoch_detail::Record* record = records.load(std::memory_order_acquire); record != nullptr;
+             record = record->next) {
+            std::uint64_t state = record->state.load(std::memory_order_acquire);
+            if ((state & 1) != 0 && (state >> 1) != epoch) {
+                return false;
+            }
+        }
+        return globalEpoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+    }
+
+    std::size_t freeBucket(epoch_detail::Bucket& bucket) {
+        for (const epoch_detail::Retired& retired : bucket.blocks) {
+            if (retired.destroy != nullptr) {
+                retired.destroy(retired.block);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            for (const epoch_detail::Retired& retired : bucket.blocks) {
+                pool.deallocate(retired.block);
+            }
+        }
+        std::size_t count = bucket.blocks.size();
+        bucket.blocks.clear();
+        reclaimedCount.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    std::size_t reclaim(epoch_detail::Record* record) {
+        std::uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+        std::size_t count = 0;
+        for (epoch_detail::Bucket& bucket : record->buckets) {
+            if (!bucket.blocks.empty() && bucket.epoch + 2 <= epoch) {
+                count += freeBucket(bucket);
+            }
+        }
+        std::vector<epoch_detail::Bucket> ready;
+        {
+            // Destructors run after the lock is released, since they may retire
+            std::lock_guard<std::mutex> lock(orphanMutex);
+            auto pending = std::partition(orphans.begin(), orphans.end(), [epoch](const epoch_detail::Bucket& orphan) {
+                return orphan.epoch + 2 > epoch;
+            });
+            ready.assign(std::make_move_iterator(pending), std::make_move_iterator(orphans.end()));
+            orphans.erase(pending, orphans.end());
+        }
+        for (epoch_detail::Bucket& orphan : ready) {
+            count += freeBucket(orphan);
+        }
+        return count;
+    }
+
+    void retireBlock(void* block, void (*destroy)(void*)) {
+        epoch_detail::Record* record = localRecord();
+        std::uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+        epoch_detail::Bucket& bucket = record->buckets[epoch % 3];
+        if (bucket.epoch != epoch) {
+            // Still holds blocks from epoch - 3, which are past their grace period
+            if (!bucket.blocks.empty()) {
+                freeBucket(bucket);
+            }
+            bucket.epoch = epoch;
+        }
+        bucket.blocks.push_back(epoch_detail::Retired{block, destroy});
+        if (++record->retiredSinceScan >= scanThreshold) {
+            record->retiredSinceScan = 0;
+            tryAdvance();
+            reclaim(record);
+        }
+    }
+
+public:
+    // Every scanThreshold retirements a thread tries to advance the epoch
+    // and reclaims what has become safe
+    explicit EpochDomain(Pool& pool, std::size_t scanThreshold = 64)
+        : pool(pool), id(Registry::registerOwner()), scanThreshold(scanThreshold > 0 ? scanThreshold : 1) {}
+
+    // No thread may be pinned any more: everything retired is reclaimed
+    ~EpochDomain() {
+        Registry::unregisterOwner(id);
+        Registry::forget(id);
+        epoch_detail::Record* record = records.load(std::memory_order_acquire);
+        while (record != nullptr) {
+            for (epoch_detail::Bucket& bucket : record->buckets) {
+                freeBucket(bucket);
+            }
+            epoch_detail::Record* next = record->next;
+            delete record;
+            record = next;
+        }
+        for (epoch_detail::Bucket& orphan : orphans) {
+            freeBucket(orphan);
+        }
+    }
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    Guard pin() {
+        epoch_detail::Record* record = localRecord();
+        if (record->nesting++ == 0) {
+            std::uint64_t epoch = globalEpoch.load(std::memory_order_relaxed);
+            record->state.store((epoch << 1) | 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst); // Publish before reading shared nodes
+        }
+        return Guard(this, record);
+    }
+
+    // Thread-safe allocation from the underlying pool
+    void* allocate() {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        return pool.allocate();
+    }
+
+    // Returns a block no other thread has seen straight to the pool
+    void deallocate(void* block) {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        pool.deallocate(block);
+    }
+
+    // Returns the block to the pool once no reader can still hold it
+    void retire(void* block) {
+        retireBlock(block, nullptr);
+    }
+
+    // Same, running the destructor first
+    template <typename T>
+    void retire(T* object) {
+        retireBlock(object, &epoch_detail::destroyObject<T>);
+    }
+
+    // Tries to advance the epoch and reclaims this thread's retired blocks
+    // that are past their grace period. Returns the number reclaimed.
+    std::size_t collect() {
+        tryAdvance();
+        return reclaim(localRecord());
+    }
+
+    std::uint64_t getEpoch() const {
+        return globalEpoch.load(std::memory_order_relaxed);
+    }
+
+    // Blocks handed back to the pool so far
+    std::size_t getReclaimedCount() const {
+        return reclaimedCount.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,607 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) && !defined(MPM_FLAT_HASH_MAP_PORTABLE)
+#include <emmintrin.h>
+#endif
+
+#include "PoolAllocator.hpp"
+
+// Control bytes and group probing for FlatHashMap. Every slot has one control
+// byte: empty, deleted (tombstone) or the low 7 bits of the key's hash (H2).
+// Lookups compare a whole group of control bytes against H2 at once and only
+// touch slots whose byte matched.
+namespace flat_hash_detail {
+
+using ctrl_t = std::int8_t;
+
+constexpr ctrl_t kEmpty = -128;
+constexpr ctrl_t kDeleted = -2;
+
+// Set bits of a group match; iterating yields slot offsets within the group
+template <int Shift>
+class BitMask {
+private:
+    std::uint64_t mask;
+
+public:
+    explicit BitMask(std::uint64_t mask) : mask(mask) {}
+
+    explicit operator bool() const {
+        return mask != 0;
+    }
+
+    std::size_t lowest() const {
+        return static_cast<std::size_t>(__builtin_ctzll(mask)) >> Shift;
+    }
+
+    // Slots after the highest match in a group of width slots
+    std::size_t afterHighest(std::size_t width) const {
+        return (static_cast<std::size_t>(__builtin_clzll(mask)) - (64 - (width << Shift))) >> Shift;
+    }
+
+    BitMask& operator++() {
+        mask &= mask - 1;
+        return *this;
+    }
+};
+
+#if defined(__SSE2__) && !defined(MPM_FLAT_HASH_MAP_PORTABLE)
+
+class Group {
+private:
+    __m128i ctrl;
+
+public:
+    static constexpr std::size_t width = 16;
+    using Mask = BitMask<0>;
+
+    explicit Group(const ctrl_t* pos)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+    Mask match(ctrl_t h2) const {
+        return Mask(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))));
+    }
+
+    Mask matchEmpty() const {
+        return match(kEmpty);
+    }
+
+    Mask matchEmptyOrDeleted() const {
+        // Empty and deleted are the only values below -1
+        return Mask(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl))));
+    }
+};
+
+#else
+
+// Portable SWAR fallback: eight control bytes in one 64-bit word
+class Group {
+private:
+    std::uint64_t ctrl;
+
+    static constexpr std::uint64_t lsbs = 0x0101010101010101ull;
+    static constexpr std::uint64_t msbs = 0x8080808080808080ull;
+
+public:
+    static constexpr std::size_t width = 8;
+    using Mask = BitMask<3>;
+
+    explicit Group(const ctrl_t* pos) {
+        std::memcpy(&ctrl, pos, sizeof(ctrl));
+    }
+
+    // May report false positives; callers always compare the key afterwards
+    Mask match(ctrl_t h2) const {
+        std::uint64_t x = ctrl ^ (lsbs * static_cast<std::uint8_t>(h2));
+        return Mask((x - lsbs) & ~x & msbs);
+    }
+
+    Mask matchEmpty() const {
+        return Mask((ctrl & ~(ctrl << 6)) & msbs);
+    }
+
+    Mask matchEmptyOrDeleted() const {
+        return Mask((ctrl & ~(ctrl << 7)) & msbs);
+    }
+};
+
+#endif
+
+// Finalizer from MurmurHash3: spreads identity hashes of integer keys over
+// both H1 (probe start) and H2 (control byte)
+inline std::uint64_t mix(std::uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+} // namespace flat_hash_detail
+
+// Open-addressing hash map in the style of Swiss tables. Entries live inline
+// in one array next to their control bytes, so a lookup touches one group of
+// control bytes and, usually, one slot. The table is a single allocation made
+// through Allocator; with a PoolAllocator over a SizeClassedPool every table
+// size has its own pool class, so growing or rehashing hands the old table
+// back to the pool for the next table of that size instead of calling malloc.
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = PoolAllocator<std::pair<const Key, Value>>>
+class FlatHashMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+
+private:
+    using ctrl_t = flat_hash_detail::ctrl_t;
+    using Group = flat_hash_detail::Group;
+
+    // Allocation unit for the table, aligned for both control bytes and slots
+    struct alignas(alignof(value_type) > alignof(std::max_align_t) ? alignof(value_type)
+                                                                    : alignof(std::max_align_t)) Chunk {
+        unsigned char bytes[alignof(value_type) > alignof(std::max_align_t) ? alignof(value_type)
+                                                                            : alignof(std::max_align_t)];
+    };
+    using ChunkAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>;
+
+    static constexpr std::size_t minCapacity = Group::width;
+
+    ctrl_t* ctrl = nullptr;
+    value_type* slots = nullptr;
+    std::size_t capacity_ = 0; // Zero or a power of two no smaller than one group
+    std::size_t size_ = 0;
+    std::size_t growthLeft = 0; // Empty slots usable before the next rehash
+    Hash hash;
+    KeyEqual equal;
+    ChunkAllocator allocator;
+
+    static std::size_t maxLoad(std::size_t capacity) {
+        return capacity - capacity / 8; // 7/8 maximum load factor
+    }
+
+    static std::size_t ctrlBytes(std::size_t capacity) {
+        // Group::width trailing bytes mirror the first group so an unaligned
+        // group load near the end wraps around without a bounds check
+        return (capacity + Group::width + sizeof(Chunk) - 1) / sizeof(Chunk) * sizeof(Chunk);
+    }
+
+    static std::size_t tableChunks(std::size_t capacity) {
+        return (ctrlBytes(capacity) + capacity * sizeof(value_type) + sizeof(Chunk) - 1) / sizeof(Chunk);
+    }
+
+    std::uint64_t hashOf(const Key& key) const {
+        return flat_hash_detail::mix(static_cast<std::uint64_t>(hash(key)));
+    }
+
+    static ctrl_t h2(std::uint64_t hashValue) {
+        return static_cast<ctrl_t>(hashValue & 0x7F);
+    }
+
+    static std::size_t h1(std::uint64_t hashValue) {
+        return static_cast<std::size_t>(hashValue >> 7);
+    }
+
+    void setCtrl(std::size_t index, ctrl_t value) {
+        ctrl[index] = value;
+        if (index < Group::width) {
+            ctrl[capacity_ + index] = value; // Keep the mirrored tail in sync
+        }
+    }
+
+    // Index of the slot holding key, or capacity_ when absent
+    std::size_t findIndex(const Key& key, std::uint64_t hashValue) const {
+        if (capacity_ == 0) {
+            return 0;
+        }
+        std::size_t mask = capacity_ - 1;
+        std::size_t offset = h1(hashValue) & mask;
+        for (std::size_t step = Group::width;; step += Group::width) {
+            Group group(ctrl + offset);
+            for (auto match = group.match(h2(hashValue)); match; ++match) {
+                std::size_t index = (offset + match.lowest()) & mask;
+                if (equal(slots[index].first, key)) {
+                    return index;
+                }
+            }
+            if (group.matchEmpty()) {
+                return capacity_;
+            }
+            offset = (offset + step) & mask; // Triangular probing visits every group
+        }
+    }
+
+    // First empty or deleted slot on the probe sequence of hashValue
+    std::size_t findInsertSlot(std::uint64_t hashValue) const {
+        std::size_t mask = capacity_ - 1;
+        std::size_t offset = h1(hashValue) & mask;
+        for (std::size_t step = Group::width;; step += Group::width) {
+            auto free = Group(ctrl + offset).matchEmptyOrDeleted();
+            if (free) {
+                return (offset + free.lowest()) & mask;
+            }
+            offset = (offset + step) & mask;
+        }
+    }
+
+    void allocateTable(std::size_t capacity) {
+        Chunk* table = std::allocator_traits<ChunkAllocator>::allocate(allocator, tableChunks(capacity));
+        ctrl = reinterpret_cast<ctrl_t*>(table);
+        slots = reinterpret_cast<value_type*>(reinterpret_cast<unsigned char*>(table) + ctrlBytes(capacity));
+        capacity_ = capacity;
+        std::memset(ctrl, static_cast<unsigned char>(flat_hash_detail::kEmpty), capacity + Group::width);
+        growthLeft = maxLoad(capacity) - size_;
+    }
+
+    void deallocateTable(ctrl_t* oldCtrl, std::size_t oldCapacity) {
+        if (oldCtrl != nullptr) {
+            std::allocator_traits<ChunkAllocator>::deallocate(
+                allocator, reinterpret_cast<Chunk*>(oldCtrl), tableChunks(oldCapacity));
+        }
+    }
+
+    void destroyAll() {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (ctrl[i] >= 0) {
+                slots[i].~value_type();
+            }
+        }
+    }
+
+    // Moves every entry into a fresh table of newCapacity; tombstones are dropped
+    void resize(std::size_t newCapacity) {
+        ctrl_t* oldCtrl = ctrl;
+        value_type* oldSlots = slots;
+        std::size_t oldCapacity = capacity_;
+
+        allocateTable(newCapacity);
+        for (std::size_t i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] >= 0) {
+                std::uint64_t hashValue = hashOf(oldSlots[i].first);
+                std::size_t index = findInsertSlot(hashValue);
+                setCtrl(index, h2(hashValue));
+                new (slots + index) value_type(std::move(oldSlots[i]));
+                oldSlots[i].~value_type();
+            }
+        }
+        deallocateTable(oldCtrl, oldCapacity);
+    }
+
+    void moveSlot(std::size_t from, std::size_t to) {
+        new (slots + to) value_type(std::move(slots[from]));
+        slots[from].~value_type();
+    }
+
+    // Which group of hashValue's probe sequence covers index
+    std::size_t probeGroup(std::size_t index, std::uint64_t hashValue) const {
+        return ((index - h1(hashValue)) & (capacity_ - 1)) / Group::width;
+    }
+
+    // Rehashes at the same capacity without allocating: tombstones become
+    // empty and every entry moves to the first free slot of its probe
+    // sequence. Entries still to be placed are marked deleted while it runs.
+    void dropTombstones() {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            ctrl[i] = ctrl[i] >= 0 ? flat_hash_detail::kDeleted : flat_hash_detail::kEmpty;
+        }
+        std::memcpy(ctrl + capacity_, ctrl, Group::width);
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (ctrl[i] != flat_hash_detail::kDeleted) {
+                continue;
+            }
+            std::uint64_t hashValue = hashOf(slots[i].first);
+            std::size_t target = findInsertSlot(hashValue);
+            if (probeGroup(target, hashValue) == probeGroup(i, hashValue)) {
+                setCtrl(i, h2(hashValue)); // Already in the first group with room
+            } else if (ctrl[target] == flat_hash_detail::kEmpty) {
+                moveSlot(i, target);
+                setCtrl(target, h2(hashValue));
+                setCtrl(i, flat_hash_detail::kEmpty);
+            } else {
+                // target holds an entry not placed yet: swap and place that one next
+                value_type displaced(std::move(slots[target]));
+                slots[target].~value_type();
+                moveSlot(i, target);
+                new (slots + i) value_type(std::move(displaced));
+                setCtrl(target, h2(hashValue));
+                --i;
+            }
+        }
+        growthLeft = maxLoad(capacity_) - size_;
+    }
+
+    void makeRoomForInsert() {
+        if (capacity_ == 0) {
+            allocateTable(minCapacity);
+        } else if (size_ * 32 <= capacity_ * 25) {
+            dropTombstones(); // Tombstones hold the missing room
+        } else {
+            resize(capacity_ * 2);
+        }
+    }
+
+    template <typename K, typename... Args>
+    std::pair<std::size_t, bool> emplaceKey(const K& key, Args&&... args) {
+        std::uint64_t hashValue = hashOf(key);
+        std::size_t found = findIndex(key, hashValue);
+        if (found != capacity_) {
+            return {found, false};
+        }
+        std::size_t index = capacity_ == 0 ? 0 : findInsertSlot(hashValue);
+        if (capacity_ == 0 || (growthLeft == 0 && ctrl[index] != flat_hash_detail::kDeleted)) {
+            makeRoomForInsert();
+            index = findInsertSlot(hashValue);
+        }
+        new (slots + index) value_type(std::forward<Args>(args)...);
+        if (ctrl[index] == flat_hash_detail::kEmpty) {
+            --growthLeft;
+        }
+        setCtrl(index, h2(hashValue));
+        ++size_;
+        return {index, true};
+    }
+
+public:
+    template <bool Const>
+    class Iterator {
+    private:
+        friend class FlatHashMap;
+        template <bool>
+        friend class Iterator;
+        using Map = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+
+        Map* map = nullptr;
+        std::size_t index = 0;
+
+        Iterator(Map* map, std::size_t index) : map(map), index(index) {
+            skipEmpty();
+        }
+
+        void skipEmpty() {
+            while (index < map->capacity_ && map->ctrl[index] < 0) {
+                ++index;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+        Iterator() = default;
+
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) : map(other.map), index(other.index) {}
+
+        reference operator*() const {
+            return map->slots[index];
+        }
+
+        pointer operator->() const {
+            return map->slots + index;
+        }
+
+        Iterator& operator++() {
+            ++index;
+            skipEmpty();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) {
+            return a.index == b.index;
+        }
+
+        friend bool operator!=(const Iterator& a, const Iterator& b) {
+            return a.index != b.index;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit FlatHashMap(const Allocator& allocator, const Hash& hash = Hash(),
+                         const KeyEqual& equal = KeyEqual())
+        : hash(hash), equal(equal), allocator(allocator) {
+    }
+
+    FlatHashMap(const FlatHashMap& other)
+        : hash(other.hash), equal(other.equal), allocator(other.allocator) {
+        reserve(other.size_);
+        for (const value_type& entry : other) {
+            emplaceKey(entry.first, entry);
+        }
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept
+        : ctrl(std::exchange(other.ctrl, nullptr)),
+          slots(std::exchange(other.slots, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          size_(std::exchange(other.size_, 0)),
+          growthLeft(std::exchange(other.growthLeft, 0)),
+          hash(other.hash),
+          equal(other.equal),
+          allocator(other.allocator) {
+    }
+
+    FlatHashMap& operator=(FlatHashMap other) {
+        swap(other);
+        return *this;
+    }
+
+    ~FlatHashMap() {
+        if (capacity_ != 0) {
+            destroyAll();
+            deallocateTable(ctrl, capacity_);
+        }
+    }
+
+    void swap(FlatHashMap& other) noexcept {
+        using std::swap;
+        swap(ctrl, other.ctrl);
+        swap(slots, other.slots);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growthLeft, other.growthLeft);
+        swap(hash, other.hash);
+        swap(equal, other.equal);
+        swap(allocator, other.allocator);
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, capacity_); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, capacity_); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t capacity() const { return capacity_; }
+
+    float load_factor() const {
+        return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(allocator);
+    }
+
+    // Ensures count entries fit without another rehash
+    void reserve(std::size_t count) {
+        std::size_t capacity = minCapacity;
+        while (maxLoad(capacity) < count) {
+            capacity *= 2;
+        }
+        if (capacity > capacity_) {
+            resize(capacity);
+        }
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        auto [index, inserted] = emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                            std::forward_as_tuple(std::forward<Args>(args)...));
+        return {iterator(this, index), inserted};
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        auto [index, inserted] = emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                            std::forward_as_tuple(std::forward<Args>(args)...));
+        return {iterator(this, index), inserted};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& entry) {
+        auto [index, inserted] = emplaceKey(entry.first, entry);
+        return {iterator(this, index), inserted};
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    Value& operator[](const Key& key) {
+        return try_emplace(key).first->second;
+    }
+
+    Value& at(const Key& key) {
+        iterator it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("FlatHashMap::at");
+        }
+        return it->second;
+    }
+
+    const Value& at(const Key& key) const {
+        const_iterator it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("FlatHashMap::at");
+        }
+        return it->second;
+    }
+
+    iterator find(const Key& key) {
+        std::size_t index = findIndex(key, hashOf(key));
+        return index == capacity_ ? end() : iterator(this, index);
+    }
+
+    const_iterator find(const Key& key) const {
+        std::size_t index = findIndex(key, hashOf(key));
+        return index == capacity_ ? end() : const_iterator(this, index);
+    }
+
+    bool contains(const Key& key) const {
+        return findIndex(key, hashOf(key)) != capacity_;
+    }
+
+    std::size_t count(const Key& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    void erase(iterator it) {
+        slots[it.index].~value_type();
+        --size_;
+        // A slot no probe window could have seen full goes straight back to
+        // empty: fewer than a group of occupied slots run through it, so every
+        // window holding it also holds an empty slot and stops lookups there
+        std::size_t mask = capacity_ - 1;
+        auto emptyAfter = Group(ctrl + it.index).matchEmpty();
+        auto emptyBefore = Group(ctrl + ((it.index - Group::width) & mask)).matchEmpty();
+        if (emptyAfter && emptyBefore &&
+            emptyAfter.lowest() + emptyBefore.afterHighest(Group::width) < Group::width) {
+            setCtrl(it.index, flat_hash_detail::kEmpty);
+            ++growthLeft;
+        } else {
+            setCtrl(it.index, flat_hash_detail::kDeleted);
+        }
+    }
+
+    std::size_t erase(const Key& key) {
+        iterator it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        erase(it);
+        return 1;
+    }
+
+    // Destroys all entries but keeps the table for reuse
+    void clear() {
+        if (capacity_ == 0) {
+            return;
+        }
+        destroyAll();
+        size_ = 0;
+        std::memset(ctrl, static_cast<unsigned char>(flat_hash_detail::kEmpty), capacity_ + Group::width);
+        growthLeft = maxLoad(capacity_);
+    }
+};
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "MemoryPool.hpp"
+#include "ThreadRegistry.hpp"
+
+namespace hazard_detail {
+
+// A block waiting until no hazard pointer covers it
+struct Retired {
+    void* block;
+    void (*destroy)(void* block);
+};
+
+template <typename T>
+void destroyObject(void* block) {
+    static_cast<T*>(block)->~T();
+}
+
+constexpr std::size_t slotsPerThread = 4;
+
+// Per-thread hazard slots and retired list in one domain. Records are reused
+// by later threads and only freed with the domain.
+struct alignas(64) Record {
+    std::atomic<void*> slots[slotsPerThread] = {};
+    std::atomic<bool> inUse{true};
+    Record* next = nullptr;
+    unsigned usedSlots = 0; // Bit per slot held by a Hazard
+    std::vector<Retired> retired;
+};
+
+// Process-wide: asymmetric fences need one registration per process
+inline bool membarrierReady() {
+    static const bool ready = [] {
+        long commands = ::syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+        if (commands < 0 || (commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED) == 0) {
+            return false;
+        }
+        return ::syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+    }();
+    return ready;
+}
+
+} // namespace hazard_detail
+
+// Hazard-pointer reclamation over a pool, for lock-free structures that must
+// stay within a memory bound even when a thread stalls. A reader publishes
+// the node it is about to use in a hazard slot; a retired node goes back to
+// the pool once no slot holds it. Each thread scans when its retired list
+// reaches the bound, and a scan can only keep nodes that are currently
+// protected, so a thread never holds more than bound retired nodes however
+// long another thread stalls. An exiting thread scans once more and leaves
+// what is still protected on its record; the next thread to take the record
+// inherits those nodes within its own bound, so exited threads add nothing
+// beyond bound per record. On Linux, protect() pays only a compiler barrier:
+// the scanning thread issues membarrier(PRIVATE_EXPEDITED), which acts as a
+// full fence on every thread of the process. Without membarrier, protect()
+// falls back to a seq_cst fence.
+template <typename Pool = MemoryPool>
+class HazardDomain {
+public:
+    // One hazard slot of the calling thread, held for the Hazard's lifetime
+    class Hazard {
+    private:
+        friend class HazardDomain;
+
+        hazard_detail::Record* record;
+        unsigned slot;
+
+        Hazard(hazard_detail::Record* record, unsigned slot) : record(record), slot(slot) {}
+
+    public:
+        Hazard(Hazard&& other) noexcept
+            : record(std::exchange(other.record, nullptr)), slot(other.slot) {}
+
+        Hazard(const Hazard&) = delete;
+        Hazard& operator=(const Hazard&) = delete;
+        Hazard& operator=(Hazard&&) = delete;
+
+        ~Hazard() {
+            if (record != nullptr) {
+                reset();
+                record->usedSlots &= ~(1u << slot);
+            }
+        }
+
+        // Loads source and publishes it until the two agree; the returned
+        // node cannot be reclaimed until reset() or another protect()
+        template <typename T>
+        T* protect(const std::atomic<T*>& source) {
+            T* node = source.load(std::memory_order_relaxed);
+            while (true) {
+                record->slots[slot].store(node, std::memory_order_relaxed);
+                if (hazard_detail::membarrierReady()) {
+                    std::atomic_signal_fence(std::memory_order_seq_cst); // Scanner supplies the fence
+                } else {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                }
+                T* again = source.load(std::memory_order_acquire);
+                if (again == node) {
+                    return node;
+                }
+                node = again;
+            }
+        }
+
+        void reset() {
+            record->slots[slot].store(nullptr, std::memory_order_release);
+        }
+    };
+
+private:
+    using Registry = ThreadRegistry<HazardDomain, hazard_detail::Record*>;
+    friend Registry;
+
+    Pool& pool;
+    std::uint64_t id;
+    std::size_t retiredBound;
+    std::mutex poolMutex;
+    std::atomic<hazard_detail::Record*> records{nullptr};
+    std::atomic<std::size_t> reclaimedCount{0};
+
+    hazard_detail::Record* acquireRecord() {
+        for (hazard_detail::Record* record = records.load(std::memory_order_acquire); record != nullptr;
+             record = record->next) {
+            bool expected = false;
+            if (!record->inUse.load(std::memory_order_relaxed) &&
+                record->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return record;
+            }
+        }
+        auto* record = new hazard_detail::Record();
+        record->retired.reserve(retiredBound);
+        hazard_detail::Record* head = records.load(std::memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+        return record;
+    }
+
+    hazard_detail::Record* localRecord() {
+        if (hazard_detail::Record** record = Registry::find(id)) {
+            return *record;
+        }
+        return Registry::attach(id, this, acquireRecord());
+    }
+
+    static void heavyFence() {
+        if (hazard_detail::membarrierReady()) {
+            ::syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        } else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    // Frees every entry of retired that no hazard slot covers; keeps the rest
+    std::size_t scan(std::vector<hazard_detail::Retired>& retired) {
+        heavyFence(); // Makes every reader's published slot visible
+        std::vector<void*> hazards;
+        for (hazard_detail::Record* record = records.load(std::memory_order_acquire); record != nullptr;
+             record = record->next) {
+            for (const std::atomic<void*>& slot : record->slots) {
+                void* hazard = slot.load(std::memory_order_acquire);
+                if (hazard != nullptr) {
+                    hazards.push_back(hazard);
+                }
+            }
+        }
+        std::sort(hazards.begin(), hazards.end());
+
+        auto protectedEnd = std::partition(retired.begin(), retired.end(),
+                                           [&hazards](const hazard_detail::Retired& entry) {
+                                               return std::binary_search(hazards.begin(), hazards.end(), entry.block);
+                                           });
+        for (auto entry = protectedEnd; entry != retired.end(); ++entry) {
+            if (entry->destroy != nullptr) {
+                entry->destroy(entry->block);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            for (auto entry = protectedEnd; entry != retired.end(); ++entry) {
+                pool.deallocate(entry->block);
+            }
+        }
+        std::size_t freed = static_cast<std::size_t>(retired.end() - protectedEnd);
+        retired.erase(protectedEnd, retired.end());
+        reclaimedCount.fetch_add(freed, std::memory_order_relaxed);
+        return freed;
+    }
+
+    // Thread exit: scans once; nodes still protected stay on the record for
+    // the next thread that takes it, so they count against its bound
+    void detachThread(hazard_detail::Record* record) {
+        for (std::atomic<void*>& slot : record->slots) {
+            slot.store(nullptr, std::memory_order_release);
+        }
+        scan(record->retired);
+        record->usedSlots = 0;
+        record->inUse.store(false, std::memory_order_release);
+    }
+
+    void retireBlock(void* block, void (*destroy)(void*)) {
+        hazard_detail::Record* record = localRecord();
+        record->retired.push_back(hazard_detail::Retired{block, destroy});
+        if (record->retired.size() >= retiredBound) {
+            scan(record->retired);
+        }
+    }
+
+public:
+    // retiredBound is the most retired nodes a thread holds before it scans.
+    // A scan keeps at most slotsPerThread * threads nodes, so the bound
+    // should be well above that for scans to pay off.
+    explicit HazardDomain(Pool& pool, std::size_t retiredBound = 128)
+        : pool(pool), id(Registry::registerOwner()), retiredBound(retiredBound > 0 ? retiredBound : 1) {}
+
+    // No thread may hold a hazard any more: everything retired is reclaimed
+    ~HazardDomain() {
+        Registry::unregisterOwner(id);
+        Registry::forget(id);
+        std::vector<hazard_detail::Retired> all;
+        for (hazard_detail::Record* record = records.load(std::memory_order_acquire); record != nullptr;
+             record = record->next) {
+            all.insert(all.end(), record->retired.begin(), record->retired.end());
+            for (std::atomic<void*>& slot : record->slots) {
+                slot.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        scan(all);
+        hazard_detail::Record* record = records.load(std::memory_order_acquire);
+        while (record != nullptr) {
+            hazard_detail::Record* next = record->next;
+            delete record;
+            record = next;
+        }
+    }
+
+    HazardDomain(const HazardDomain&) = delete;
+    HazardDomain& operator=(const HazardDomain&) = delete;
+
+    // Takes one of the calling thread's hazard slots
+    Hazard makeHazard() {
+        hazard_detail::Record* record = localRecord();
+        for (unsigned slot = 0; slot < hazard_detail::slotsPerThread; ++slot) {
+            if ((record->usedSlots & (1u << slot)) == 0) {
+                record->usedSlots |= 1u << slot;
+                return Hazard(record, slot);
+            }
+        }
+        throw std::length_error("HazardDomain: all hazard slots of this thread are in use");
+    }
+
+    // Thread-safe allocation from the underlying pool
+    void* allocate() {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        return pool.allocate();
+    }
+
+    void retire(void* block) {
+        retireBlock(block, nullptr);
+    }
+
+    // Same, running the destructor first
+    template <typename T>
+    void retire(T* object) {
+        retireBlock(object, &hazard_detail::destroyObject<T>);
+    }
+
+    // Scans now: frees this thread's unprotected retired nodes, including
+    // any an exited thread left on the record. Returns the number reclaimed.
+    std::size_t collect() {
+        return scan(localRecord()->retired);
+    }
+
+    std::size_t getRetiredBound() const {
+        return retiredBound;
+    }
+
+    // Nodes this thread has retired that are not yet reclaimed
+    std::size_t getPendingCount() {
+        return localRecord()->retired.size();
+    }
+
+    // Blocks handed back to the pool so far
+    std::size_t getReclaimedCount() const {
+        return reclaimedCount.load(std::memory_order_relaxed);
+    }
+
+    // Whether protect() runs without a hardware fence
+    static bool usesAsymmetricFences() {
+        return hazard_detail::membarrierReady();
+    }
+};
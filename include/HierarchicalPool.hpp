@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <vector>
+
+// Byte limits for one node of a HierarchicalPool tree, counted over the chunks
+// held by the node and its descendants. Crossing the soft limit raises a flag
+// and calls the node's handler; a chunk that would cross the hard limit is
+// refused and the allocation throws std::bad_alloc.
+struct PoolQuota {
+    std::size_t softBytes = std::numeric_limits<std::size_t>::max();
+    std::size_t hardBytes = std::numeric_limits<std::size_t>::max();
+};
+
+// Tree of fixed-size block pools, e.g. one child per tenant under a shared
+// root. A node carves blocks from whole chunks that it draws from its parent;
+// the root draws them from the system. Quotas and usage are accounted per
+// chunk under a lock shared by the tree, so allocate/deallocate of a block
+// touch only the node's own free list. Each node is used from one thread at a
+// time; different nodes may be used from different threads. Children must be
+// destroyed before their parent.
+class HierarchicalPool {
+public:
+    using SoftLimitHandler = std::function<void(HierarchicalPool&)>;
+
+private:
+    HierarchicalPool* parent = nullptr;
+    HierarchicalPool* root = this;
+    std::mutex treeMutex; // Used on the root only; guards the fields below marked "tree"
+    std::size_t blockSize;
+    std::size_t stride;
+    std::size_t blocksPerChunk;
+    std::size_t chunkBytes;
+    PoolQuota quota; // tree
+    SoftLimitHandler softLimitHandler;
+
+    std::vector<void*> freeBlocks;
+    std::vector<unsigned char*> chunks; // Chunks this node carves blocks from, sorted
+    std::size_t usedCount = 0;
+
+    std::vector<unsigned char*> spareChunks; // tree: whole chunks handed back by children
+    std::size_t reservedBytes = 0; // tree: chunks held by this subtree
+    std::size_t childCount = 0; // tree
+    bool overSoftLimit = false; // tree
+
+    // Tree lock held. Nodes that crossed their soft limit are appended to crossed.
+    unsigned char* takeChunk(std::vector<HierarchicalPool*>& crossed) {
+        if (!spareChunks.empty()) {
+            unsigned char* chunk = spareChunks.back();
+            spareChunks.pop_back();
+            return chunk; // Already counted in this subtree
+        }
+        if (reservedBytes + chunkBytes > quota.hardBytes) {
+            throw std::bad_alloc();
+        }
+        unsigned char* chunk;
+        if (parent != nullptr) {
+            chunk = parent->takeChunk(crossed);
+        } else {
+            chunk = static_cast<unsigned char*>(std::malloc(chunkBytes));
+            if (chunk == nullptr) {
+                throw std::bad_alloc();
+            }
+        }
+        reservedBytes += chunkBytes;
+        if (!overSoftLimit && reservedBytes > quota.softBytes) {
+            overSoftLimit = true;
+            crossed.push_back(this);
+        }
+        return chunk;
+    }
+
+    // Tree lock held
+    void giveBack(unsigned char* chunk) {
+        reservedBytes -= chunkBytes;
+        overSoftLimit = reservedBytes > quota.softBytes;
+        if (parent != nullptr) {
+            parent->spareChunks.push_back(chunk);
+        } else {
+            std::free(chunk);
+        }
+    }
+
+    void refill() {
+        std::vector<HierarchicalPool*> crossed;
+        unsigned char* chunk;
+        {
+            std::lock_guard<std::mutex> lock(root->treeMutex);
+            chunk = takeChunk(crossed);
+        }
+        chunks.insert(std::upper_bound(chunks.begin(), chunks.end(), chunk), chunk);
+        // Hand out low addresses first
+        for (std::size_t i = blocksPerChunk; i > 0; --i) {
+            freeBlocks.push_back(chunk + (i - 1) * stride);
+        }
+        // Outside the lock, so handlers may query or trim the tree
+        for (HierarchicalPool* node : crossed) {
+            if (node->softLimitHandler) {
+                node->softLimitHandler(*node);
+            }
+        }
+    }
+
+public:
+    // Root node: chunks of blocksPerChunk blocks come from the system
+    HierarchicalPool(std::size_t blockSize, std::size_t blocksPerChunk, PoolQuota quota = PoolQuota())
+        : blockSize(blockSize),
+          stride((blockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t)),
+          blocksPerChunk(blocksPerChunk),
+          chunkBytes(stride * blocksPerChunk),
+          quota(quota) {
+        if (blockSize == 0 || blocksPerChunk == 0) {
+            throw std::invalid_argument("HierarchicalPool: blockSize and blocksPerChunk must be non-zero");
+        }
+    }
+
+    // Child node with the parent's geometry; its chunks count against every ancestor
+    HierarchicalPool(HierarchicalPool& parent, PoolQuota quota = PoolQuota())
+        : parent(&parent),
+          root(parent.root),
+          blockSize(parent.blockSize),
+          stride(parent.stride),
+          blocksPerChunk(parent.blocksPerChunk),
+          chunkBytes(parent.chunkBytes),
+          quota(quota) {
+        std::lock_guard<std::mutex> lock(root->treeMutex);
+        ++parent.childCount;
+    }
+
+    // Every chunk goes back to the parent, which keeps it for other children
+    ~HierarchicalPool() {
+        std::unique_lock<std::mutex> lock(root->treeMutex, std::defer_lock);
+        if (parent != nullptr) {
+            lock.lock();
+            --parent->childCount;
+        }
+        for (unsigned char* chunk : chunks) {
+            giveBack(chunk);
+        }
+        for (unsigned char* chunk : spareChunks) {
+            giveBack(chunk);
+        }
+    }
+
+    HierarchicalPool(const HierarchicalPool&) = delete;
+    HierarchicalPool& operator=(const HierarchicalPool&) = delete;
+
+    void* allocate() {
+        if (freeBlocks.empty()) {
+            refill();
+        }
+        void* block = freeBlocks.back();
+        freeBlocks.pop_back();
+        ++usedCount;
+        return block;
+    }
+
+    void deallocate(void* block) {
+        freeBlocks.push_back(block);
+        --usedCount;
+    }
+
+    // Returns chunks with no live blocks, and the spares kept for children, to
+    // the parent (the system for the root). Returns the number of bytes released.
+    std::size_t trim() {
+        std::sort(freeBlocks.begin(), freeBlocks.end());
+        std::vector<unsigned char*> released;
+        std::vector<void*> kept;
+        kept.reserve(freeBlocks.size());
+        std::vector<unsigned char*> remaining;
+        auto block = freeBlocks.begin();
+        for (unsigned char* chunk : chunks) {
+            auto first = block;
+            while (block != freeBlocks.end() && *block < chunk + chunkBytes) {
+                ++block;
+            }
+            if (static_cast<std::size_t>(block - first) == blocksPerChunk) {
+                released.push_back(chunk);
+            } else {
+                kept.insert(kept.end(), first, block);
+                remaining.push_back(chunk);
+            }
+        }
+        freeBlocks.swap(kept);
+        chunks.swap(remaining);
+
+        std::lock_guard<std::mutex> lock(root->treeMutex);
+        released.insert(released.end(), spareChunks.begin(), spareChunks.end());
+        spareChunks.clear();
+        for (unsigned char* chunk : released) {
+            giveBack(chunk);
+        }
+        return released.size() * chunkBytes;
+    }
+
+    // Called from the allocating thread, outside the tree lock, when this
+    // subtree first grows past its soft limit
+    void setSoftLimitHandler(SoftLimitHandler handler) {
+        softLimitHandler = std::move(handler);
+    }
+
+    void setQuota(PoolQuota newQuota) {
+        std::lock_guard<std::mutex> lock(root->treeMutex);
+        quota = newQuota;
+        overSoftLimit = reservedBytes > quota.softBytes;
+    }
+
+    PoolQuota getQuota() const {
+        std::lock_guard<std::mutex> lock(root->treeMutex);
+        return quota;
+    }
+
+    // Bytes of chunks held by this node and its descendants
+    std::size_t getReservedBytes() const {
+        std::lock_guard<std::mutex> lock(root->treeMutex);
+        return reservedBytes;
+    }
+
+    bool isOverSoftLimit() const {
+        std::lock_guard<std::mutex> lock(root->treeMutex);
+        return overSoftLimit;
+    }
+
+    std::size_t getChildCount() const {
+        std::lock_guard<std::mutex> lock(root->treeMutex);
+        return childCount;
+    }
+
+    HierarchicalPool* getParent() const {
+        return parent;
+    }
+
+    std::size_t getBlockSize() const {
+        return blockSize;
+    }
+
+    std::size_t getChunkBytes() const {
+        return chunkBytes;
+    }
+
+    // Blocks of this node currently handed out
+    std::size_t getUsedCount() const {
+        return usedCount;
+    }
+
+    // Blocks this node can hand out before it needs another chunk
+    std::size_t getAvailableCount() const {
+        return freeBlocks.size();
+    }
+};
@@ -0,0 +1,991 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+// Intrusive containers link objects through hooks the objects carry
+// themselves, so inserting allocates nothing: the object is typically made
+// once with PoolManager::create and then indexed by reference. An object
+// derives from one hook per index it can sit in, each told apart by a tag
+// type, e.g. struct Order : ListHook<ByLevel>, TreeHook<ByPrice>,
+// HashHook<ById>. The containers never own their elements; an object must be
+// removed from every index before it is destroyed. Copying an object gives
+// the copy unlinked hooks.
+
+template <typename Tag = void>
+class ListHook {
+private:
+    template <typename, typename>
+    friend class IntrusiveList;
+
+    ListHook* prev = nullptr;
+    ListHook* next = nullptr;
+
+public:
+    ListHook() = default;
+    ListHook(const ListHook&) noexcept {}
+    ListHook& operator=(const ListHook&) noexcept { return *this; }
+
+    bool is_linked() const { return next != nullptr; }
+};
+
+template <typename Tag = void>
+class TreeHook {
+private:
+    template <typename, typename, typename>
+    friend class IntrusiveTree;
+
+    enum class Color : unsigned char { unlinked, red, black };
+
+    TreeHook* parent = nullptr;
+    TreeHook* left = nullptr;
+    TreeHook* right = nullptr;
+    Color color = Color::unlinked;
+
+public:
+    TreeHook() = default;
+    TreeHook(const TreeHook&) noexcept {}
+    TreeHook& operator=(const TreeHook&) noexcept { return *this; }
+
+    bool is_linked() const { return color != Color::unlinked; }
+};
+
+template <typename Tag = void>
+class HashHook {
+private:
+    template <typename, typename, typename, typename>
+    friend class IntrusiveHashTable;
+
+    HashHook* next = nullptr;
+    std::size_t hash = 0; // Cached so rehash() and mismatches skip the hasher
+    bool linked = false;
+
+public:
+    HashHook() = default;
+    HashHook(const HashHook&) noexcept {}
+    HashHook& operator=(const HashHook&) noexcept { return *this; }
+
+    bool is_linked() const { return linked; }
+};
+
+// Doubly linked list through ListHook<Tag>. Every operation is O(1) apart
+// from clear(), which unlinks each element.
+template <typename T, typename Tag = void>
+class IntrusiveList {
+private:
+    using Hook = ListHook<Tag>;
+
+    Hook head; // Sentinel; never a T
+    std::size_t size_ = 0;
+
+    static Hook* hookOf(T& item) { return static_cast<Hook*>(&item); }
+    static T* ownerOf(Hook* hook) { return static_cast<T*>(hook); }
+
+    void resetHead() {
+        head.prev = &head;
+        head.next = &head;
+    }
+
+    static void linkBefore(Hook* position, Hook* hook) {
+        hook->next = position;
+        hook->prev = position->prev;
+        position->prev->next = hook;
+        position->prev = hook;
+    }
+
+    static void unlink(Hook* hook) {
+        hook->prev->next = hook->next;
+        hook->next->prev = hook->prev;
+        hook->prev = nullptr;
+        hook->next = nullptr;
+    }
+
+    // Moves other's elements behind our (empty) sentinel
+    void steal(IntrusiveList& other) {
+        if (other.empty()) {
+            resetHead();
+        } else {
+            head.next = other.head.next;
+            head.prev = other.head.prev;
+            head.next->prev = &head;
+            head.prev->next = &head;
+            other.resetHead();
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    template <bool Const>
+    class Iterator {
+    private:
+        friend class IntrusiveList;
+
+        Hook* hook = nullptr;
+
+        explicit Iterator(Hook* hook) : hook(hook) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() = default;
+
+        // Non-const to const conversion
+        template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) : hook(other.hook) {}
+
+        reference operator*() const { return *ownerOf(hook); }
+        pointer operator->() const { return ownerOf(hook); }
+
+        Iterator& operator++() {
+            hook = hook->next;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            hook = hook->next;
+            return previous;
+        }
+
+        Iterator& operator--() {
+            hook = hook->prev;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator previous = *this;
+            hook = hook->prev;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.hook == b.hook; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.hook != b.hook; }
+    };
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    IntrusiveList() {
+        resetHead();
+    }
+
+    IntrusiveList(IntrusiveList&& other) noexcept {
+        steal(other);
+    }
+
+    IntrusiveList& operator=(IntrusiveList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            steal(other);
+        }
+        return *this;
+    }
+
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    ~IntrusiveList() {
+        clear();
+    }
+
+    iterator begin() { return iterator(head.next); }
+    iterator end() { return iterator(&head); }
+    const_iterator begin() const { return const_iterator(head.next); }
+    const_iterator end() const { return const_iterator(const_cast<Hook*>(&head)); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T& front() { return *ownerOf(head.next); }
+    const T& front() const { return *ownerOf(head.next); }
+    T& back() { return *ownerOf(head.prev); }
+    const T& back() const { return *ownerOf(head.prev); }
+
+    // Iterator to an element known to be in this list
+    iterator iterator_to(T& item) { return iterator(hookOf(item)); }
+    const_iterator iterator_to(const T& item) const { return const_iterator(hookOf(const_cast<T&>(item))); }
+
+    // item must not already be in a list through this hook
+    iterator insert(const_iterator position, T& item) {
+        Hook* hook = hookOf(item);
+        linkBefore(position.hook, hook);
+        ++size_;
+        return iterator(hook);
+    }
+
+    void push_front(T& item) { insert(begin(), item); }
+    void push_back(T& item) { insert(end(), item); }
+
+    iterator erase(const_iterator position) {
+        Hook* next = position.hook->next;
+        unlink(position.hook);
+        --size_;
+        return iterator(next);
+    }
+
+    void remove(T& item) { erase(iterator_to(item)); }
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(iterator(head.prev)); }
+
+    // Unlinks every element; the elements themselves are untouched
+    void clear() {
+        Hook* hook = head.next;
+        while (hook != &head) {
+            Hook* next = hook->next;
+            hook->prev = nullptr;
+            hook->next = nullptr;
+            hook = next;
+        }
+        resetHead();
+        size_ = 0;
+    }
+};
+
+// Red-black tree through TreeHook<Tag>, ordered by Compare. Equal elements
+// are allowed and keep their insertion order. Lookups take any key Compare
+// can compare against a T in both argument orders, so a comparator with
+// overloads for (const T&, Key) and (Key, const T&) finds by key alone.
+template <typename T, typename Tag = void, typename Compare = std::less<T>>
+class IntrusiveTree {
+private:
+    using Hook = TreeHook<Tag>;
+    using Color = typename Hook::Color;
+
+    Hook* root = nullptr;
+    std::size_t size_ = 0;
+    Compare compare;
+
+    static Hook* hookOf(const T& item) { return const_cast<Hook*>(static_cast<const Hook*>(&item)); }
+    static T* ownerOf(Hook* hook) { return static_cast<T*>(hook); }
+
+    static bool isRed(const Hook* hook) { return hook != nullptr && hook->color == Color::red; }
+
+    static Hook* minimum(Hook* hook) {
+        while (hook->left != nullptr) {
+            hook = hook->left;
+        }
+        return hook;
+    }
+
+    static Hook* maximum(Hook* hook) {
+        while (hook->right != nullptr) {
+            hook = hook->right;
+        }
+        return hook;
+    }
+
+    static Hook* successor(Hook* hook) {
+        if (hook->right != nullptr) {
+            return minimum(hook->right);
+        }
+        Hook* parent = hook->parent;
+        while (parent != nullptr && hook == parent->right) {
+            hook = parent;
+            parent = parent->parent;
+        }
+        return parent;
+    }
+
+    static Hook* predecessor(Hook* hook) {
+        if (hook->left != nullptr) {
+            return maximum(hook->left);
+        }
+        Hook* parent = hook->parent;
+        while (parent != nullptr && hook == parent->left) {
+            hook = parent;
+            parent = parent->parent;
+        }
+        return parent;
+    }
+
+    static void reset(Hook* hook) {
+        hook->parent = nullptr;
+        hook->left = nullptr;
+        hook->right = nullptr;
+        hook->color = Color::unlinked;
+    }
+
+    // Points whatever referred to from at to instead
+    void replaceChild(Hook* from, Hook* to) {
+        Hook* parent = from->parent;
+        if (parent == nullptr) {
+            root = to;
+        } else if (from == parent->left) {
+            parent->left = to;
+        } else {
+            parent->right = to;
+        }
+        if (to != nullptr) {
+            to->parent = parent;
+        }
+    }
+
+    void rotateLeft(Hook* hook) {
+        Hook* pivot = hook->right;
+        hook->right = pivot->left;
+        if (pivot->left != nullptr) {
+            pivot->left->parent = hook;
+        }
+        replaceChild(hook, pivot);
+        pivot->left = hook;
+        hook->parent = pivot;
+    }
+
+    void rotateRight(Hook* hook) {
+        Hook* pivot = hook->left;
+        hook->left = pivot->right;
+        if (pivot->right != nullptr) {
+            pivot->right->parent = hook;
+        }
+        replaceChild(hook, pivot);
+        pivot->right = hook;
+        hook->parent = pivot;
+    }
+
+    void rebalanceAfterInsert(Hook* hook) {
+        while (isRed(hook->parent)) {
+            Hook* parent = hook->parent;
+            Hook* grandparent = parent->parent; // Exists, the root is black
+            if (parent == grandparent->left) {
+                Hook* uncle = grandparent->right;
+                if (isRed(uncle)) {
+                    parent->color = Color::black;
+                    uncle->color = Color::black;
+                    grandparent->color = Color::red;
+                    hook = grandparent;
+                    continue;
+                }
+                if (hook == parent->right) {
+                    rotateLeft(parent);
+                    parent = hook;
+                }
+                parent->color = Color::black;
+                grandparent->color = Color::red;
+                rotateRight(grandparent);
+                break;
+            } else {
+                Hook* uncle = grandparent->left;
+                if (isRed(uncle)) {
+                    parent->color = Color::black;
+                    uncle->color = Color::black;
+                    grandparent->color = Color::red;
+                    hook = grandparent;
+                    continue;
+                }
+                if (hook == parent->left) {
+                    rotateRight(parent);
+                    parent = hook;
+                }
+                parent->color = Color::black;
+                grandparent->color = Color::red;
+                rotateLeft(grandparent);
+                break;
+            }
+        }
+        root->color = Color::black;
+    }
+
+    // hook took the place of a removed black node; it may be null, hence parent
+    void rebalanceAfterErase(Hook* hook, Hook* parent) {
+        while (hook != root && !isRed(hook)) {
+            if (hook == parent->left) {
+                Hook* sibling = parent->right;
+                if (isRed(sibling)) {
+                    sibling->color = Color::black;
+                    parent->color = Color::red;
+                    rotateLeft(parent);
+                    sibling = parent->right;
+                }
+                if (!isRed(sibling->left) && !isRed(sibling->right)) {
+                    sibling->color = Color::red;
+                    hook = parent;
+                    parent = hook->parent;
+                    continue;
+                }
+                if (!isRed(sibling->right)) {
+                    sibling->left->color = Color::black;
+                    sibling->color = Color::red;
+                    rotateRight(sibling);
+                    sibling = parent->right;
+                }
+                sibling->color = parent->color;
+                parent->color = Color::black;
+                sibling->right->color = Color::black;
+                rotateLeft(parent);
+            } else {
+                Hook* sibling = parent->left;
+                if (isRed(sibling)) {
+                    sibling->color = Color::black;
+                    parent->color = Color::red;
+                    rotateRight(parent);
+                    sibling = parent->left;
+                }
+                if (!isRed(sibling->left) && !isRed(sibling->right)) {
+                    sibling->color = Color::red;
+                    hook = parent;
+                    parent = hook->parent;
+                    continue;
+                }
+                if (!isRed(sibling->left)) {
+                    sibling->right->color = Color::black;
+                    sibling->color = Color::red;
+                    rotateLeft(sibling);
+                    sibling = parent->left;
+                }
+                sibling->color = parent->color;
+                parent->color = Color::black;
+                sibling->left->color = Color::black;
+                rotateRight(parent);
+            }
+            hook = root;
+        }
+        if (hook != nullptr) {
+            hook->color = Color::black;
+        }
+    }
+
+    void unlink(Hook* hook) {
+        Color removedColor = hook->color;
+        Hook* replacement;
+        Hook* replacementParent;
+        if (hook->left == nullptr) {
+            replacement = hook->right;
+            replacementParent = hook->parent;
+            replaceChild(hook, hook->right);
+        } else if (hook->right == nullptr) {
+            replacement = hook->left;
+            replacementParent = hook->parent;
+            replaceChild(hook, hook->left);
+        } else {
+            // Two children: the in-order successor takes hook's place
+            Hook* next = minimum(hook->right);
+            removedColor = next->color;
+            replacement = next->right;
+            if (next->parent == hook) {
+                replacementParent = next;
+            } else {
+                replacementParent = next->parent;
+                replaceChild(next, next->right);
+                next->right = hook->right;
+                next->right->parent = next;
+            }
+            replaceChild(hook, next);
+            next->left = hook->left;
+            next->left->parent = next;
+            next->color = hook->color;
+        }
+        if (removedColor == Color::black) {
+            rebalanceAfterErase(replacement, replacementParent);
+        }
+        reset(hook);
+        --size_;
+    }
+
+    template <bool Const>
+    class Iterator {
+    private:
+        friend class IntrusiveTree;
+
+        using Tree = std::conditional_t<Const, const IntrusiveTree, IntrusiveTree>;
+
+        Tree* tree = nullptr;
+        Hook* hook = nullptr; // Null at end()
+
+        Iterator(Tree* tree, Hook* hook) : tree(tree), hook(hook) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() = default;
+
+        // Non-const to const conversion
+        template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) : tree(other.tree), hook(other.hook) {}
+
+        reference operator*() const { return *ownerOf(hook); }
+        pointer operator->() const { return ownerOf(hook); }
+
+        Iterator& operator++() {
+            hook = successor(hook);
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        Iterator& operator--() {
+            hook = hook == nullptr ? maximum(tree->root) : predecessor(hook);
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.hook == b.hook; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.hook != b.hook; }
+    };
+
+    // First element not ordered before key
+    template <typename Key>
+    Hook* lowerBound(const Key& key) const {
+        Hook* found = nullptr;
+        Hook* hook = root;
+        while (hook != nullptr) {
+            if (compare(*ownerOf(hook), key)) {
+                hook = hook->right;
+            } else {
+                found = hook;
+                hook = hook->left;
+            }
+        }
+        return found;
+    }
+
+    // First element ordered after key
+    template <typename Key>
+    Hook* upperBound(const Key& key) const {
+        Hook* found = nullptr;
+        Hook* hook = root;
+        while (hook != nullptr) {
+            if (compare(key, *ownerOf(hook))) {
+                found = hook;
+                hook = hook->left;
+            } else {
+                hook = hook->right;
+            }
+        }
+        return found;
+    }
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit IntrusiveTree(Compare compare = Compare()) : compare(std::move(compare)) {}
+
+    IntrusiveTree(IntrusiveTree&& other) noexcept
+        : root(std::exchange(other.root, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          compare(std::move(other.compare)) {}
+
+    IntrusiveTree& operator=(IntrusiveTree&& other) noexcept {
+        if (this != &other) {
+            clear();
+            root = std::exchange(other.root, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            compare = std::move(other.compare);
+        }
+        return *this;
+    }
+
+    IntrusiveTree(const IntrusiveTree&) = delete;
+    IntrusiveTree& operator=(const IntrusiveTree&) = delete;
+
+    ~IntrusiveTree() {
+        clear();
+    }
+
+    iterator begin() { return iterator(this, root == nullptr ? nullptr : minimum(root)); }
+    iterator end() { return iterator(this, nullptr); }
+    const_iterator begin() const { return const_iterator(this, root == nullptr ? nullptr : minimum(root)); }
+    const_iterator end() const { return const_iterator(this, nullptr); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Smallest and largest elements; the tree must not be empty
+    T& front() { return *ownerOf(minimum(root)); }
+    const T& front() const { return *ownerOf(minimum(root)); }
+    T& back() { return *ownerOf(maximum(root)); }
+    const T& back() const { return *ownerOf(maximum(root)); }
+
+    iterator iterator_to(T& item) { return iterator(this, hookOf(item)); }
+    const_iterator iterator_to(const T& item) const { return const_iterator(this, hookOf(item)); }
+
+    // item must not already be in a tree through this hook. O(log n).
+    iterator insert(T& item) {
+        Hook* hook = hookOf(item);
+        Hook* parent = nullptr;
+        bool left = false;
+        for (Hook* cursor = root; cursor != nullptr;) {
+            parent = cursor;
+            left = compare(item, *ownerOf(cursor));
+            cursor = left ? cursor->left : cursor->right;
+        }
+        hook->parent = parent;
+        hook->left = nullptr;
+        hook->right = nullptr;
+        hook->color = Color::red;
+        if (parent == nullptr) {
+            root = hook;
+        } else if (left) {
+            parent->left = hook;
+        } else {
+            parent->right = hook;
+        }
+        ++size_;
+        rebalanceAfterInsert(hook);
+        return iterator(this, hook);
+    }
+
+    iterator erase(const_iterator position) {
+        Hook* next = successor(position.hook);
+        unlink(position.hook);
+        return iterator(this, next);
+    }
+
+    void remove(T& item) { unlink(hookOf(item)); }
+
+    template <typename Key>
+    iterator lower_bound(const Key& key) { return iterator(this, lowerBound(key)); }
+
+    template <typename Key>
+    const_iterator lower_bound(const Key& key) const { return const_iterator(this, lowerBound(key)); }
+
+    template <typename Key>
+    iterator upper_bound(const Key& key) { return iterator(this, upperBound(key)); }
+
+    template <typename Key>
+    const_iterator upper_bound(const Key& key) const { return const_iterator(this, upperBound(key)); }
+
+    // First element equal to key, or end()
+    template <typename Key>
+    iterator find(const Key& key) {
+        Hook* hook = lowerBound(key);
+        return iterator(this, hook != nullptr && !compare(key, *ownerOf(hook)) ? hook : nullptr);
+    }
+
+    template <typename Key>
+    const_iterator find(const Key& key) const {
+        Hook* hook = lowerBound(key);
+        return const_iterator(this, hook != nullptr && !compare(key, *ownerOf(hook)) ? hook : nullptr);
+    }
+
+    template <typename Key>
+    bool contains(const Key& key) const {
+        return find(key) != end();
+    }
+
+    // Unlinks every element in O(n) without rebalancing
+    void clear() {
+        Hook* hook = root;
+        while (hook != nullptr) {
+            if (hook->left != nullptr) {
+                hook = hook->left;
+            } else if (hook->right != nullptr) {
+                hook = hook->right;
+            } else {
+                Hook* parent = hook->parent;
+                if (parent != nullptr) {
+                    (parent->left == hook ? parent->left : parent->right) = nullptr;
+                }
+                reset(hook);
+                hook = parent;
+            }
+        }
+        root = nullptr;
+        size_ = 0;
+    }
+};
+
+// Chained hash table through HashHook<Tag> with unique keys. The bucket array
+// is allocated up front and only replaced by rehash(), so insert() never
+// allocates; size the table for the expected element count. Like
+// IntrusiveTree, lookups take any key that Hash and KeyEqual accept, with
+// KeyEqual called as (const T&, const Key&).
+template <typename T, typename Tag = void, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class IntrusiveHashTable {
+private:
+    using Hook = HashHook<Tag>;
+
+    std::unique_ptr<Hook*[]> buckets;
+    std::size_t bucketMask;
+    unsigned bucketShift; // Bits of a hash left over after the bucket index
+    std::size_t size_ = 0;
+    Hash hasher;
+    KeyEqual equal;
+
+    static Hook* hookOf(const T& item) { return const_cast<Hook*>(static_cast<const Hook*>(&item)); }
+    static T* ownerOf(Hook* hook) { return static_cast<T*>(hook); }
+
+    static unsigned shiftFor(std::size_t count) {
+        return static_cast<unsigned>(sizeof(std::size_t) * 8 - __builtin_ctzll(count));
+    }
+
+    static std::size_t roundUpPowerOfTwo(std::size_t count) {
+        std::size_t rounded = 2; // Keeps bucketShift below the width of a hash
+        while (rounded < count) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    // Fibonacci hashing: the top bits of hash times 2^64/phi pick the bucket,
+    // which spreads identity hashes of sequential ids evenly
+    static std::size_t mix(std::size_t hash) {
+        return hash * static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+    }
+
+    std::size_t bucketOf(std::size_t hash) const {
+        return hash >> bucketShift;
+    }
+
+    template <typename Key>
+    Hook* findHook(const Key& key, std::size_t hash) const {
+        if (buckets == nullptr) {
+            return nullptr; // Moved from
+        }
+        for (Hook* hook = buckets[bucketOf(hash)]; hook != nullptr; hook = hook->next) {
+            if (hook->hash == hash && equal(*ownerOf(hook), key)) {
+                return hook;
+            }
+        }
+        return nullptr;
+    }
+
+    template <bool Const>
+    class Iterator {
+    private:
+        friend class IntrusiveHashTable;
+
+        using Table = std::conditional_t<Const, const IntrusiveHashTable, IntrusiveHashTable>;
+
+        Table* table = nullptr;
+        Hook* hook = nullptr; // Null at end()
+
+        Iterator(Table* table, Hook* hook) : table(table), hook(hook) {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() = default;
+
+        // Non-const to const conversion
+        template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) : table(other.table), hook(other.hook) {}
+
+        reference operator*() const { return *ownerOf(hook); }
+        pointer operator->() const { return ownerOf(hook); }
+
+        Iterator& operator++() {
+            hook = hook->next != nullptr ? hook->next : table->firstFrom(table->bucketOf(hook->hash) + 1);
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.hook == b.hook; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.hook != b.hook; }
+    };
+
+    // First element in bucket index or later
+    Hook* firstFrom(std::size_t index) const {
+        if (buckets == nullptr) {
+            return nullptr;
+        }
+        for (; index <= bucketMask; ++index) {
+            if (buckets[index] != nullptr) {
+                return buckets[index];
+            }
+        }
+        return nullptr;
+    }
+
+    void unlink(Hook* hook) {
+        Hook** link = &buckets[bucketOf(hook->hash)];
+        while (*link != hook) {
+            link = &(*link)->next;
+        }
+        *link = hook->next;
+        hook->next = nullptr;
+        hook->linked = false;
+        --size_;
+    }
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // bucketCount is rounded up to a power of two, at least two
+    explicit IntrusiveHashTable(std::size_t bucketCount = 64, Hash hasher = Hash(), KeyEqual equal = KeyEqual())
+        : buckets(new Hook*[roundUpPowerOfTwo(bucketCount)]()),
+          bucketMask(roundUpPowerOfTwo(bucketCount) - 1),
+          bucketShift(shiftFor(bucketMask + 1)),
+          hasher(std::move(hasher)),
+          equal(std::move(equal)) {}
+
+    // Takes over the bucket array; other is left empty without buckets and
+    // needs rehash() before its next insert()
+    IntrusiveHashTable(IntrusiveHashTable&& other) noexcept
+        : buckets(std::move(other.buckets)),
+          bucketMask(std::exchange(other.bucketMask, 0)),
+          bucketShift(other.bucketShift),
+          size_(std::exchange(other.size_, 0)),
+          hasher(std::move(other.hasher)),
+          equal(std::move(other.equal)) {}
+
+    IntrusiveHashTable& operator=(IntrusiveHashTable&& other) noexcept {
+        if (this != &other) {
+            clear();
+            buckets = std::move(other.buckets);
+            bucketMask = std::exchange(other.bucketMask, 0);
+            bucketShift = other.bucketShift;
+            size_ = std::exchange(other.size_, 0);
+            hasher = std::move(other.hasher);
+            equal = std::move(other.equal);
+        }
+        return *this;
+    }
+
+    IntrusiveHashTable(const IntrusiveHashTable&) = delete;
+    IntrusiveHashTable& operator=(const IntrusiveHashTable&) = delete;
+
+    ~IntrusiveHashTable() {
+        clear();
+    }
+
+    iterator begin() { return iterator(this, firstFrom(0)); }
+    iterator end() { return iterator(this, nullptr); }
+    const_iterator begin() const { return const_iterator(this, firstFrom(0)); }
+    const_iterator end() const { return const_iterator(this, nullptr); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t bucket_count() const { return buckets == nullptr ? 0 : bucketMask + 1; }
+
+    float load_factor() const {
+        return buckets == nullptr ? 0.0f : static_cast<float>(size_) / static_cast<float>(bucket_count());
+    }
+
+    iterator iterator_to(T& item) { return iterator(this, hookOf(item)); }
+
+    // Links item unless an equal element is already present, which is
+    // returned instead. item must not already be in a table through this hook.
+    std::pair<iterator, bool> insert(T& item) {
+        std::size_t hash = mix(hasher(item));
+        if (Hook* existing = findHook(item, hash)) {
+            return {iterator(this, existing), false};
+        }
+        Hook* hook = hookOf(item);
+        Hook*& bucket = buckets[bucketOf(hash)];
+        hook->hash = hash;
+        hook->next = bucket;
+        hook->linked = true;
+        bucket = hook;
+        ++size_;
+        return {iterator(this, hook), true};
+    }
+
+    template <typename Key>
+    iterator find(const Key& key) {
+        return iterator(this, findHook(key, mix(hasher(key))));
+    }
+
+    template <typename Key>
+    const_iterator find(const Key& key) const {
+        return const_iterator(this, findHook(key, mix(hasher(key))));
+    }
+
+    template <typename Key>
+    bool contains(const Key& key) const {
+        return find(key) != end();
+    }
+
+    iterator erase(const_iterator position) {
+        iterator next(this, position.hook);
+        ++next;
+        unlink(position.hook);
+        return next;
+    }
+
+    // Keeps erase(find(key)) away from the key overload below
+    iterator erase(iterator position) {
+        return erase(const_iterator(position));
+    }
+
+    void remove(T& item) { unlink(hookOf(item)); }
+
+    // Unlinks the element equal to key, if any
+    template <typename Key>
+    std::size_t erase(const Key& key) {
+        Hook* hook = findHook(key, mix(hasher(key)));
+        if (hook == nullptr) {
+            return 0;
+        }
+        unlink(hook);
+        return 1;
+    }
+
+    // Moves the elements to a new array of bucketCount buckets, rounded as in
+    // the constructor; the only operation that allocates
+    void rehash(std::size_t bucketCount) {
+        std::size_t count = roundUpPowerOfTwo(bucketCount);
+        unsigned shift = shiftFor(count);
+        std::unique_ptr<Hook*[]> fresh(new Hook*[count]());
+        for (std::size_t i = 0; buckets != nullptr && i <= bucketMask; ++i) {
+            Hook* hook = buckets[i];
+            while (hook != nullptr) {
+                Hook* next = hook->next;
+                Hook*& bucket = fresh[hook->hash >> shift];
+                hook->next = bucket;
+                bucket = hook;
+                hook = next;
+            }
+        }
+        buckets = std::move(fresh);
+        bucketMask = count - 1;
+        bucketShift = shift;
+    }
+
+    // Unlinks every element; the elements themselves are untouched
+    void clear() {
+        for (std::size_t i = 0; buckets != nullptr && i <= bucketMask; ++i) {
+            Hook* hook = std::exchange(buckets[i], nullptr);
+            while (hook != nullptr) {
+                Hook* next = hook->next;
+                hook->next = nullptr;
+                hook->linked = false;
+                hook = next;
+            }
+        }
+        size_ = 0;
+    }
+};
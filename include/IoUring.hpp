@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Minimal io_uring instance on raw syscalls: one submission and one
+// completion ring, enough to drive fixed-buffer and provided-buffer I/O
+// without depending on liburing.
+class IoUring {
+private:
+    int fd = -1;
+    io_uring_params params{};
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    std::size_t sqRingSize = 0;
+    std::size_t cqRingSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    unsigned sqeTail = 0; // Next SQE to hand out
+    unsigned sqeSubmitted = 0; // SQEs already published to the kernel
+
+    [[noreturn]] static void fail(int error, const char* what) {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    template <typename T>
+    T* at(void* ring, std::uint32_t offset) {
+        return reinterpret_cast<T*>(static_cast<unsigned char*>(ring) + offset);
+    }
+
+    void unmap() {
+        if (sqes != MAP_FAILED) {
+            ::munmap(sqes, params.sq_entries * sizeof(io_uring_sqe));
+        }
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            ::munmap(cqRing, cqRingSize);
+        }
+        if (sqRing != MAP_FAILED) {
+            ::munmap(sqRing, sqRingSize);
+        }
+    }
+
+public:
+    explicit IoUring(unsigned entries) {
+        fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            fail(errno, "IoUring: io_uring_setup");
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap && cqRingSize > sqRingSize) {
+            sqRingSize = cqRingSize;
+        }
+        sqRing = ::mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                        IORING_OFF_SQ_RING);
+        cqRing = singleMmap ? sqRing
+                            : ::mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                     IORING_OFF_CQ_RING);
+        sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe),
+                                                 PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                                 IORING_OFF_SQES));
+        if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqes == MAP_FAILED) {
+            int error = errno;
+            unmap();
+            ::close(fd);
+            fail(error, "IoUring: mmap");
+        }
+
+        sqHead = at<unsigned>(sqRing, params.sq_off.head);
+        sqTail = at<unsigned>(sqRing, params.sq_off.tail);
+        sqMask = *at<unsigned>(sqRing, params.sq_off.ring_mask);
+        cqHead = at<unsigned>(cqRing, params.cq_off.head);
+        cqTail = at<unsigned>(cqRing, params.cq_off.tail);
+        cqMask = *at<unsigned>(cqRing, params.cq_off.ring_mask);
+        cqes = at<io_uring_cqe>(cqRing, params.cq_off.cqes);
+
+        // SQEs are always consumed in order, so the index array is the identity
+        unsigned* array = at<unsigned>(sqRing, params.sq_off.array);
+        for (unsigned i = 0; i < params.sq_entries; ++i) {
+            array[i] = i;
+        }
+    }
+
+    ~IoUring() {
+        unmap();
+        ::close(fd);
+    }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    int descriptor() const {
+        return fd;
+    }
+
+    // Zeroed SQE to fill in, or nullptr when the submission ring is full
+    io_uring_sqe* getSqe() {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (sqeTail - head >= params.sq_entries) {
+            return nullptr;
+        }
+        io_uring_sqe* sqe = &sqes[sqeTail & sqMask];
+        std::memset(sqe, 0, sizeof(*sqe));
+        ++sqeTail;
+        return sqe;
+    }
+
+    // Publishes pending SQEs and waits until at least waitFor completions are ready
+    unsigned submit(unsigned waitFor = 0) {
+        unsigned pending = sqeTail - sqeSubmitted;
+        __atomic_store_n(sqTail, sqeTail, __ATOMIC_RELEASE);
+        sqeSubmitted = sqeTail;
+        int rc = static_cast<int>(::syscall(__NR_io_uring_enter, fd, pending, waitFor,
+                                            waitFor > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+        if (rc < 0) {
+            fail(errno, "IoUring: io_uring_enter");
+        }
+        return static_cast<unsigned>(rc);
+    }
+
+    // Copies out and consumes the oldest completion, if any
+    bool popCqe(io_uring_cqe& cqe) {
+        unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        cqe = cqes[head & cqMask];
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    io_uring_cqe waitCqe() {
+        io_uring_cqe cqe;
+        while (!popCqe(cqe)) {
+            submit(1);
+        }
+        return cqe;
+    }
+
+    // io_uring_register; returns the raw result and throws on failure
+    int registerResource(unsigned opcode, const void* arg, unsigned count) {
+        int rc = static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+        if (rc < 0) {
+            fail(errno, "IoUring: io_uring_register");
+        }
+        return rc;
+    }
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// RAII wrapper for a shared read-write mapping of a file or shared-memory
+// object. The file is grown to at least the requested length; existing
+// contents are kept, which is what lets a pool resume from a previous run or
+// attach to a segment another process created.
+class MappedFile {
+private:
+    int fd = -1;
+    void* base = nullptr;
+    std::size_t length = 0;
+    bool created = false;
+
+    [[noreturn]] static void fail(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    [[noreturn]] void closeAndFail(const char* what) {
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        fail(what);
+    }
+
+    void map() {
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            closeAndFail("MappedFile: fstat");
+        }
+        created = info.st_size == 0;
+        if (length == 0) {
+            length = static_cast<std::size_t>(info.st_size); // Attach to whatever is there
+        } else if (static_cast<std::size_t>(info.st_size) < length &&
+                   ::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+            closeAndFail("MappedFile: ftruncate");
+        }
+        if (length == 0) {
+            errno = EINVAL;
+            closeAndFail("MappedFile: empty file");
+        }
+        base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            closeAndFail("MappedFile: mmap");
+        }
+    }
+
+public:
+    MappedFile(const std::string& path, std::size_t length) : length(length) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            fail("MappedFile: open");
+        }
+        map();
+    }
+
+    // Adopts an open descriptor (shm_open, memfd_create); a zero length maps
+    // the object at its current size
+    MappedFile(int fd, std::size_t length) : fd(fd), length(length) {
+        map();
+    }
+
+    ~MappedFile() {
+        ::munmap(base, length);
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void* data() const {
+        return base;
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+
+    int descriptor() const {
+        return fd;
+    }
+
+    // True when the file was empty before this mapping was made
+    bool wasCreated() const {
+        return created;
+    }
+
+    // Writes dirty pages back to the file and waits for completion
+    void sync() const {
+        if (::msync(base, length, MS_SYNC) != 0) {
+            fail("MappedFile: msync");
+        }
+    }
+};
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+
+// Layout of the first page of a file-backed pool. Links are offsets from the
+// start of the mapping, so the file stays valid wherever it is mapped next.
+struct MappedPoolHeader {
+    static constexpr std::uint64_t expectedMagic = 0x4C4F4F504D504D31ull; // "1MPMPOOL"
+    static constexpr std::uint32_t expectedVersion = 1;
+
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint64_t blockSize;
+    std::uint64_t capacity;
+    std::uint64_t dataOffset; // Offset of the first block
+    std::uint64_t stride; // Distance between consecutive blocks
+    std::uint64_t freeHead; // Offset of the first free block, 0 when exhausted
+    std::uint64_t freeCount;
+    std::uint64_t root; // Offset of the application's root object, 0 when unset
+};
+
+// Selects MemoryPool's contiguous mode
+struct ContiguousBlocks {};
+
+class MemoryPool {
+private:
+    std::vector<void*> blocks;
+    std::size_t blockSize;
+    std::size_t capacity;
+    unsigned char* slab = nullptr; // Set in contiguous mode
+    std::size_t slabBytes = 0;
+    std::unique_ptr<MappedFile> mapped; // Set in file-backed mode
+    MappedPoolHeader* header = nullptr;
+    bool restored = false;
+
+    static constexpr std::size_t pageSize = 4096;
+
+    unsigned char* mappedBase() const {
+        return static_cast<unsigned char*>(mapped->data());
+    }
+
+    void requireFileBacked(const char* operation) const {
+        if (!mapped) {
+            throw std::logic_error(std::string("MemoryPool::") + operation + ": pool is not file-backed");
+        }
+    }
+
+    void initializeHeader(std::size_t stride, std::size_t dataOffset) {
+        header->version = MappedPoolHeader::expectedVersion;
+        header->headerSize = sizeof(MappedPoolHeader);
+        header->blockSize = blockSize;
+        header->capacity = capacity;
+        header->dataOffset = dataOffset;
+        header->stride = stride;
+        header->root = 0;
+        // Thread the free list in address order so fresh pools hand out
+        // blocks front to back
+        for (std::size_t i = 0; i < capacity; ++i) {
+            std::uint64_t next = i + 1 < capacity ? dataOffset + (i + 1) * stride : 0;
+            std::memcpy(mappedBase() + dataOffset + i * stride, &next, sizeof(next));
+        }
+        header->freeHead = capacity > 0 ? dataOffset : 0;
+        header->freeCount = capacity;
+        mapped->sync();
+        header->magic = MappedPoolHeader::expectedMagic; // Written last: marks the file valid
+    }
+
+    void* allocateMapped() {
+        if (header->freeHead == 0) {
+            throw std::bad_alloc();
+        }
+        unsigned char* block = mappedBase() + header->freeHead;
+        std::memcpy(&header->freeHead, block, sizeof(std::uint64_t));
+        --header->freeCount;
+        return block;
+    }
+
+    void deallocateMapped(void* block) {
+        std::uint64_t next = header->freeHead;
+        std::memcpy(block, &next, sizeof(next));
+        header->freeHead = toOffset(block);
+        ++header->freeCount;
+    }
+
+public:
+    MemoryPool(std::size_t blockSize, std::size_t capacity)
+        : blockSize(blockSize), capacity(capacity) {
+        blocks.reserve(capacity);
+        for (std::size_t i = 0; i < capacity; ++i) {
+            void* block = std::malloc(blockSize); // Allocate a block of memory
+            if (block == nullptr) {
+                for (void* allocated : blocks) {
+                    std::free(allocated);
+                }
+                throw std::bad_alloc();
+            }
+            blocks.push_back(block);
+        }
+    }
+
+    // Aligned blocks, e.g. page-aligned I/O buffers; alignment must be a power of two
+    MemoryPool(std::size_t blockSize, std::size_t capacity, std::size_t alignment)
+        : blockSize(blockSize), capacity(capacity) {
+        std::size_t allocationSize = (blockSize + alignment - 1) / alignment * alignment;
+        blocks.reserve(capacity);
+        for (std::size_t i = 0; i < capacity; ++i) {
+            void* block = std::aligned_alloc(alignment, allocationSize);
+            if (block == nullptr) {
+                for (void* allocated : blocks) {
+                    std::free(allocated);
+                }
+                throw std::bad_alloc();
+            }
+            blocks.push_back(block);
+        }
+    }
+
+    // Contiguous mode: all blocks are carved from one allocation, spaced by
+    // blockSize rounded up to the fundamental alignment, so owns() is a range check
+    MemoryPool(std::size_t blockSize, std::size_t capacity, ContiguousBlocks)
+        : blockSize(blockSize), capacity(capacity) {
+        std::size_t stride = (blockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                             alignof(std::max_align_t);
+        slabBytes = stride * capacity;
+        slab = static_cast<unsigned char*>(std::malloc(slabBytes > 0 ? slabBytes : 1));
+        if (slab == nullptr) {
+            throw std::bad_alloc();
+        }
+        blocks.reserve(capacity);
+        for (std::size_t i = capacity; i > 0; --i) {
+            blocks.push_back(slab + (i - 1) * stride); // Low addresses are handed out first
+        }
+    }
+
+    // File-backed mode: blocks and the free list live in a shared mapping of
+    // backingFile. If the file already holds a pool with the same geometry,
+    // its allocated blocks and root are resumed as they were left; objects
+    // stored there must link to each other by offset (toOffset/fromOffset).
+    MemoryPool(std::size_t blockSize, std::size_t capacity, const std::string& backingFile)
+        : blockSize(blockSize), capacity(capacity) {
+        if (blockSize < sizeof(std::uint64_t)) {
+            throw std::invalid_argument("MemoryPool: file-backed blocks must hold a 64-bit free-list link");
+        }
+        std::size_t stride = (blockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                             alignof(std::max_align_t);
+        std::size_t dataOffset = (sizeof(MappedPoolHeader) + pageSize - 1) / pageSize * pageSize;
+        mapped = std::make_unique<MappedFile>(backingFile, dataOffset + stride * capacity);
+        header = static_cast<MappedPoolHeader*>(mapped->data());
+
+        if (header->magic != MappedPoolHeader::expectedMagic) {
+            initializeHeader(stride, dataOffset);
+            return;
+        }
+        if (header->version != MappedPoolHeader::expectedVersion || header->blockSize != blockSize ||
+            header->capacity != capacity || header->stride != stride || header->dataOffset != dataOffset) {
+            throw std::invalid_argument("MemoryPool: backing file holds a pool with a different geometry");
+        }
+        restored = true;
+    }
+
+    ~MemoryPool() {
+        if (slab != nullptr) {
+            std::free(slab);
+            return;
+        }
+        for (void* block : blocks) {
+            std::free(block); // Free all allocated blocks
+        }
+    }
+
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    void* allocate() {
+        if (mapped) {
+            return allocateMapped();
+        }
+        if (blocks.empty()) {
+            throw std::bad_alloc(); // If no blocks left, throw bad_alloc
+        }
+        void* block = blocks.back(); // Get last allocated block
+        blocks.pop_back(); // Remove from available blocks
+        return block; // Return memory block
+    }
+
+    void deallocate(void* block) {
+        if (mapped) {
+            deallocateMapped(block);
+            return;
+        }
+        blocks.push_back(block); // Return the block to the pool
+    }
+
+    // Heap mode only: adds count blocks, e.g. when a size class runs dry.
+    // The free list is reserved for the new capacity up front.
+    void grow(std::size_t count) {
+        if (slab != nullptr || mapped) {
+            throw std::logic_error("MemoryPool::grow: only heap-mode pools grow");
+        }
+        blocks.reserve(capacity + count);
+        for (std::size_t i = 0; i < count; ++i) {
+            void* block = std::malloc(blockSize);
+            if (block == nullptr) {
+                throw std::bad_alloc(); // Blocks added so far stay in the pool
+            }
+            blocks.push_back(block);
+            ++capacity;
+        }
+    }
+
+    bool hasAvailableMemory() const {
+        return mapped ? header->freeHead != 0 : !blocks.empty();
+    }
+
+    std::size_t getBlockSize() const {
+        return blockSize;
+    }
+
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+
+    std::size_t getAvailableCount() const {
+        return mapped ? static_cast<std::size_t>(header->freeCount) : blocks.size();
+    }
+
+    bool isFileBacked() const {
+        return mapped != nullptr;
+    }
+
+    bool isContiguous() const {
+        return slab != nullptr;
+    }
+
+    // Whether block lies in this pool; contiguous and file-backed modes only
+    bool owns(const void* block) const {
+        auto address = static_cast<const unsigned char*>(block);
+        if (slab != nullptr) {
+            return address >= slab && address < slab + slabBytes;
+        }
+        if (mapped) {
+            return address >= mappedBase() + header->dataOffset && address < mappedBase() + mapped->size();
+        }
+        return false;
+    }
+
+    // True when a file-backed pool resumed the state left in its file
+    bool wasRestored() const {
+        return restored;
+    }
+
+    // Position-independent references into a file-backed pool; 0 is null.
+    // These and the root throw std::logic_error on other pools.
+    std::uint64_t toOffset(const void* block) const {
+        requireFileBacked("toOffset");
+        return block == nullptr ? 0 : static_cast<std::uint64_t>(static_cast<const unsigned char*>(block) - mappedBase());
+    }
+
+    void* fromOffset(std::uint64_t offset) const {
+        requireFileBacked("fromOffset");
+        return offset == 0 ? nullptr : mappedBase() + offset;
+    }
+
+    // Entry point a restarted process uses to find its objects again
+    void setRoot(const void* block) {
+        requireFileBacked("setRoot");
+        header->root = toOffset(block);
+    }
+
+    void* getRoot() const {
+        requireFileBacked("getRoot");
+        return fromOffset(header->root);
+    }
+
+    // Flushes a file-backed pool to disk
+    void sync() const {
+        if (mapped) {
+            mapped->sync();
+        }
+    }
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+// Umbrella header for the MemoryPoolManager library
+#include "MemoryPool.hpp"
+#include "PoolAllocator.hpp"
+#include "PoolManager.hpp"
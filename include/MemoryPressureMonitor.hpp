@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "MemoryPool.hpp"
+
+enum class PressureLevel {
+    normal,
+    low, // Free blocks at or below the low watermark
+    critical // Free blocks at or below the critical watermark
+};
+
+// Watches a pool's free-block count against low and critical watermarks and
+// notifies registered callbacks, so caches can shed entries and admission
+// control can throttle before allocate() throws. The pool's own allocate and
+// deallocate are untouched: poll() samples the pool at a point the caller
+// picks, e.g. between requests, and runs the callbacks there. Raising the
+// level notifies at once; while the level stays raised, or after it drops,
+// callbacks run at most once per minInterval. Call poll() from the thread
+// that uses the pool.
+template <typename Pool = MemoryPool>
+class MemoryPressureMonitor {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void(PressureLevel level, std::size_t availableBlocks)>;
+
+private:
+    Pool& pool;
+    std::size_t lowWatermark;
+    std::size_t criticalWatermark;
+    Clock::duration minInterval;
+    std::vector<Callback> callbacks;
+    PressureLevel level = PressureLevel::normal;
+    PressureLevel notifiedLevel = PressureLevel::normal;
+    Clock::time_point lastNotified;
+    std::size_t notificationCount = 0;
+
+    PressureLevel classify(std::size_t available) const {
+        if (available <= criticalWatermark) {
+            return PressureLevel::critical;
+        }
+        if (available <= lowWatermark) {
+            return PressureLevel::low;
+        }
+        return PressureLevel::normal;
+    }
+
+    void notify(std::size_t available, Clock::time_point now) {
+        notifiedLevel = level;
+        lastNotified = now;
+        ++notificationCount;
+        for (Callback& callback : callbacks) {
+            callback(level, available);
+        }
+    }
+
+public:
+    // Watermarks count free blocks; criticalWatermark must not exceed lowWatermark
+    MemoryPressureMonitor(Pool& pool, std::size_t lowWatermark, std::size_t criticalWatermark,
+                          Clock::duration minInterval = std::chrono::milliseconds(100))
+        : pool(pool),
+          lowWatermark(lowWatermark),
+          criticalWatermark(criticalWatermark),
+          minInterval(minInterval) {
+        if (criticalWatermark > lowWatermark) {
+            throw std::invalid_argument("MemoryPressureMonitor: critical watermark above low watermark");
+        }
+    }
+
+    void onPressure(Callback callback) {
+        callbacks.push_back(std::move(callback));
+    }
+
+    // Samples the pool and runs the callbacks if a notification is due.
+    // Returns the current level.
+    PressureLevel poll() {
+        std::size_t available = pool.getAvailableCount();
+        level = classify(available);
+        if (level == PressureLevel::normal && notifiedLevel == PressureLevel::normal) {
+            return level; // Common case: no clock read
+        }
+        Clock::time_point now = Clock::now();
+        if (level > notifiedLevel || now - lastNotified >= minInterval) {
+            notify(available, now);
+        }
+        return level;
+    }
+
+    // Level seen by the last poll(), e.g. for admission control
+    PressureLevel getLevel() const {
+        return level;
+    }
+
+    std::size_t getLowWatermark() const {
+        return lowWatermark;
+    }
+
+    std::size_t getCriticalWatermark() const {
+        return criticalWatermark;
+    }
+
+    std::size_t getNotificationCount() const {
+        return notificationCount;
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Bounded multi-producer multi-consumer queue over a ring of preallocated
+// cells (Vyukov's design). Every cell carries a sequence number telling
+// producers and consumers whose turn it is, so a push or pop is one CAS on
+// the shared index plus one store to the cell, and nothing is allocated
+// after construction. Typical use is handing pool blocks between threads:
+// MpmcRing<Job*> with jobs from a PoolManager. tryPush() fails when full,
+// tryPop() when empty; neither blocks.
+template <typename T>
+class MpmcRing {
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    static constexpr std::size_t cacheLine = 64;
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask;
+    alignas(cacheLine) std::atomic<std::size_t> enqueuePos{0};
+    alignas(cacheLine) std::atomic<std::size_t> dequeuePos{0};
+
+    static std::size_t checkedCapacity(std::size_t capacity) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("MpmcRing: capacity must be a power of two of at least 2");
+        }
+        return capacity;
+    }
+
+    template <typename U>
+    bool push(U&& item) {
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    ::new (static_cast<void*>(cell.storage)) T(std::forward<U>(item));
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // The consumer of the previous lap has not freed the cell
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    explicit MpmcRing(std::size_t capacity)
+        : cells(new Cell[checkedCapacity(capacity)]), mask(capacity - 1) {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpmcRing() {
+        if (!std::is_trivially_destructible<T>::value) {
+            std::size_t end = enqueuePos.load(std::memory_order_acquire);
+            for (std::size_t pos = dequeuePos.load(std::memory_order_acquire); pos != end; ++pos) {
+                cells[pos & mask].value()->~T();
+            }
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    bool tryPush(const T& item) {
+        return push(item);
+    }
+
+    bool tryPush(T&& item) {
+        return push(std::move(item));
+    }
+
+    bool tryPop(T& item) {
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* value = cell.value();
+                    item = std::move(*value);
+                    value->~T();
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release); // Free for the next lap
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::size_t getCapacity() const {
+        return mask + 1;
+    }
+
+    // Exact only while no other thread is pushing or popping
+    std::size_t getSize() const {
+        return enqueuePos.load(std::memory_order_acquire) - dequeuePos.load(std::memory_order_acquire);
+    }
+};
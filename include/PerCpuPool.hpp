@@ -0,0 +1,348 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+#include "PoolManager.hpp"
+
+#if defined(__linux__) && defined(__x86_64__) && defined(__has_include)
+#if __has_include(<sys/rseq.h>) && !defined(MPM_PER_CPU_POOL_NO_RSEQ)
+#include <sys/rseq.h>
+#define MPM_HAVE_RSEQ 1
+#endif
+#endif
+
+// Where PerCpuPool keeps its caches
+enum class CacheMode : unsigned char {
+    perCpu,   // One cache per CPU, updated with restartable sequences
+    perThread // PoolManager's thread caches
+};
+
+namespace per_cpu_detail {
+
+// Layout of one CPU's cache: a count followed by that many block pointers,
+// padded to whole cache lines
+struct CpuCacheHeader {
+    std::uint64_t count;
+};
+
+#if MPM_HAVE_RSEQ
+
+inline struct rseq* rseqArea() {
+    return reinterpret_cast<struct rseq*>(static_cast<char*>(__builtin_thread_pointer()) + __rseq_offset);
+}
+
+// CPU the calling thread runs on, or -1 when this thread has no rseq area
+inline int currentCpu() {
+    if (__rseq_size == 0) {
+        return -1;
+    }
+    return static_cast<int>(__atomic_load_n(&rseqArea()->cpu_id, __ATOMIC_RELAXED));
+}
+
+// Pushes block onto the cache of cpu. Returns 0 on success, 1 when the cache
+// is full, 2 when the thread was preempted, migrated or signalled, in which
+// case nothing was committed.
+inline int rseqPush(CpuCacheHeader* cache, int cpu, std::uint64_t capacity, void* block) {
+    struct rseq* area = rseqArea();
+    asm goto(
+        ".pushsection __rseq_cs, \"aw\"\n\t"
+        ".balign 32\n\t"
+        "3:\n\t"
+        ".long 0x0, 0x0\n\t"
+        ".quad 1f, (2f - 1f), 4f\n\t"
+        ".popsection\n\t"
+        "leaq 3b(%%rip), %%rax\n\t"
+        "movq %%rax, %[rseqCs]\n\t"
+        "1:\n\t"
+        "cmpl %[cpu], %[cpuId]\n\t"
+        "jnz 4f\n\t"
+        "movq (%[cache]), %%rcx\n\t"
+        "cmpq %[capacity], %%rcx\n\t"
+        "jae %l[full]\n\t"
+        "movq %[block], 8(%[cache], %%rcx, 8)\n\t"
+        "incq %%rcx\n\t"
+        "movq %%rcx, (%[cache])\n\t" // Commit
+        "2:\n\t"
+        ".pushsection __rseq_failure, \"ax\"\n\t"
+        ".long 0x53053053\n\t" // RSEQ_SIG precedes the abort handler
+        "4:\n\t"
+        "jmp %l[aborted]\n\t"
+        ".popsection\n\t"
+        :
+        : [rseqCs] "m"(area->rseq_cs), [cpuId] "m"(area->cpu_id), [cpu] "r"(cpu), [cache] "r"(cache),
+          [capacity] "r"(capacity), [block] "r"(block)
+        : "memory", "cc", "rax", "rcx"
+        : full, aborted);
+    return 0;
+full:
+    return 1;
+aborted:
+    return 2;
+}
+
+// Pops the newest block of cpu's cache into *block. Same results, with 1
+// meaning the cache is empty.
+inline int rseqPop(CpuCacheHeader* cache, int cpu, void** block) {
+    struct rseq* area = rseqArea();
+    asm goto(
+        ".pushsection __rseq_cs, \"aw\"\n\t"
+        ".balign 32\n\t"
+        "3:\n\t"
+        ".long 0x0, 0x0\n\t"
+        ".quad 1f, (2f - 1f), 4f\n\t"
+        ".popsection\n\t"
+        "leaq 3b(%%rip), %%rax\n\t"
+        "movq %%rax, %[rseqCs]\n\t"
+        "1:\n\t"
+        "cmpl %[cpu], %[cpuId]\n\t"
+        "jnz 4f\n\t"
+        "movq (%[cache]), %%rcx\n\t"
+        "testq %%rcx, %%rcx\n\t"
+        "jz %l[empty]\n\t"
+        "movq (%[cache], %%rcx, 8), %%rax\n\t" // Slot count - 1 sits at offset 8 * count
+        "movq %%rax, (%[block])\n\t"
+        "decq %%rcx\n\t"
+        "movq %%rcx, (%[cache])\n\t" // Commit
+        "2:\n\t"
+        ".pushsection __rseq_failure, \"ax\"\n\t"
+        ".long 0x53053053\n\t"
+        "4:\n\t"
+        "jmp %l[aborted]\n\t"
+        ".popsection\n\t"
+        :
+        : [rseqCs] "m"(area->rseq_cs), [cpuId] "m"(area->cpu_id), [cpu] "r"(cpu), [cache] "r"(cache),
+          [block] "r"(block)
+        : "memory", "cc", "rax", "rcx"
+        : empty, aborted);
+    return 0;
+empty:
+    return 1;
+aborted:
+    return 2;
+}
+
+#endif
+
+inline bool rseqAvailable() {
+#if MPM_HAVE_RSEQ
+    return currentCpu() >= 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace per_cpu_detail
+
+// Thread-safe fixed-size block pool whose caches are per CPU rather than per
+// thread. With thousands of mostly idle threads, per-thread caches strand
+// blocks in every thread; here the cached blocks are bounded by
+// cpus * blocksPerCpu however many threads there are. Each CPU's cache is a
+// stack updated with Linux restartable sequences: push and pop are a few
+// plain loads and stores that the kernel restarts if the thread is
+// preempted, migrated or signalled before the final store, so they need no
+// atomics. An empty or full cache refills from or drains half of itself into
+// a central PoolManager under a mutex. Without rseq (not Linux x86-64, glibc
+// older than 2.35, or registration disabled through GLIBC_TUNABLES), or
+// with CacheMode::perThread, the pool is a PoolManager with per-thread
+// caches of blocksPerCpu blocks.
+class PerCpuPool {
+private:
+    PoolManager central;
+    CacheMode mode;
+    std::size_t blocksPerCpu;
+    std::mutex centralMutex; // Per-CPU mode only; the thread-cache mode locks inside PoolManager
+    std::size_t cacheStride = 0; // Bytes per CPU cache
+    std::size_t cpuCount = 0;
+    unsigned char* caches = nullptr;
+
+    static FallbackChain chainFor(CacheMode mode, std::size_t blocksPerCpu) {
+        FallbackChain chain;
+        if (mode == CacheMode::perThread) {
+            chain.threadCacheBlocks = blocksPerCpu;
+        }
+        return chain;
+    }
+
+    static CacheMode modeFor(CacheMode requested) {
+        return requested == CacheMode::perCpu && per_cpu_detail::rseqAvailable() ? CacheMode::perCpu
+                                                                                : CacheMode::perThread;
+    }
+
+    static std::size_t checkedBlocks(std::size_t blocksPerCpu) {
+        if (blocksPerCpu < 2) {
+            throw std::invalid_argument("PerCpuPool: a cache needs at least two blocks");
+        }
+        return blocksPerCpu;
+    }
+
+#if MPM_HAVE_RSEQ
+    per_cpu_detail::CpuCacheHeader* cacheOf(int cpu) const {
+        return reinterpret_cast<per_cpu_detail::CpuCacheHeader*>(caches + static_cast<std::size_t>(cpu) * cacheStride);
+    }
+
+    void* allocateSlow(int cpu) {
+        // Refill half the cache; the blocks go to whichever CPU we are on by then
+        void* batch[64];
+        std::size_t wanted = blocksPerCpu / 2 < 64 ? blocksPerCpu / 2 : 64;
+        std::size_t got = 0;
+        {
+            std::lock_guard<std::mutex> lock(centralMutex);
+            while (got < wanted && central.pool.hasAvailableMemory()) {
+                batch[got++] = central.allocate();
+            }
+        }
+        if (got == 0) {
+            throw std::bad_alloc();
+        }
+        std::size_t kept = 1;
+        while (kept < got) {
+            cpu = per_cpu_detail::currentCpu();
+            int result = per_cpu_detail::rseqPush(cacheOf(cpu), cpu, blocksPerCpu, batch[kept]);
+            if (result == 1) {
+                break;
+            }
+            kept += result == 0 ? 1 : 0;
+        }
+        if (kept < got) {
+            std::lock_guard<std::mutex> lock(centralMutex);
+            for (std::size_t i = kept; i < got; ++i) {
+                central.deallocate(batch[i]);
+            }
+        }
+        return batch[0];
+    }
+
+    void drainHalf(int cpu) {
+        void* batch[64];
+        std::size_t wanted = blocksPerCpu / 2 < 64 ? blocksPerCpu / 2 : 64;
+        std::size_t got = 0;
+        while (got < wanted) {
+            cpu = per_cpu_detail::currentCpu();
+            int result = per_cpu_detail::rseqPop(cacheOf(cpu), cpu, &batch[got]);
+            if (result == 1) {
+                break;
+            }
+            got += result == 0 ? 1 : 0;
+        }
+        std::lock_guard<std::mutex> lock(centralMutex);
+        for (std::size_t i = 0; i < got; ++i) {
+            central.deallocate(batch[i]);
+        }
+    }
+#endif
+
+public:
+    PerCpuPool(std::size_t blockSize, std::size_t capacity, std::size_t blocksPerCpu = 64,
+               CacheMode requested = CacheMode::perCpu)
+        : central(blockSize, capacity, chainFor(modeFor(requested), checkedBlocks(blocksPerCpu))),
+          mode(modeFor(requested)),
+          blocksPerCpu(blocksPerCpu) {
+        if (mode == CacheMode::perCpu) {
+            cpuCount = static_cast<std::size_t>(::sysconf(_SC_NPROCESSORS_CONF));
+            cacheStride = ((blocksPerCpu + 1) * sizeof(void*) + 63) / 64 * 64;
+            caches = static_cast<unsigned char*>(std::aligned_alloc(64, cpuCount * cacheStride));
+            if (caches == nullptr) {
+                throw std::bad_alloc();
+            }
+            for (std::size_t cpu = 0; cpu < cpuCount; ++cpu) {
+                reinterpret_cast<per_cpu_detail::CpuCacheHeader*>(caches + cpu * cacheStride)->count = 0;
+            }
+        }
+    }
+
+    // Cached blocks belong to the central pool's memory, so they need no flush
+    ~PerCpuPool() {
+        std::free(caches);
+    }
+
+    PerCpuPool(const PerCpuPool&) = delete;
+    PerCpuPool& operator=(const PerCpuPool&) = delete;
+
+    void* allocate() {
+#if MPM_HAVE_RSEQ
+        if (mode == CacheMode::perCpu) {
+            while (true) {
+                int cpu = per_cpu_detail::currentCpu();
+                if (cpu < 0 || static_cast<std::size_t>(cpu) >= cpuCount) {
+                    std::lock_guard<std::mutex> lock(centralMutex); // This thread has no rseq area
+                    return central.allocate();
+                }
+                void* block;
+                int result = per_cpu_detail::rseqPop(cacheOf(cpu), cpu, &block);
+                if (result == 0) {
+                    return block;
+                }
+                if (result == 1) {
+                    return allocateSlow(cpu);
+                }
+            }
+        }
+#endif
+        return central.allocate();
+    }
+
+    void deallocate(void* block) {
+#if MPM_HAVE_RSEQ
+        if (mode == CacheMode::perCpu) {
+            while (true) {
+                int cpu = per_cpu_detail::currentCpu();
+                if (cpu < 0 || static_cast<std::size_t>(cpu) >= cpuCount) {
+                    std::lock_guard<std::mutex> lock(centralMutex);
+                    central.deallocate(block);
+                    return;
+                }
+                int result = per_cpu_detail::rseqPush(cacheOf(cpu), cpu, blocksPerCpu, block);
+                if (result == 0) {
+                    return;
+                }
+                if (result == 1) {
+                    drainHalf(cpu);
+                }
+            }
+        }
+#endif
+        central.deallocate(block);
+    }
+
+    CacheMode getMode() const {
+        return mode;
+    }
+
+    std::size_t getBlockSize() const {
+        return central.getBlockSize();
+    }
+
+    std::size_t getBlocksPerCpu() const {
+        return blocksPerCpu;
+    }
+
+    // Caches the per-CPU mode keeps; 0 in the thread-cache mode
+    std::size_t getCpuCount() const {
+        return cpuCount;
+    }
+
+    // Blocks sitting in CPU caches, read without synchronization; 0 in the
+    // thread-cache mode
+    std::size_t getCachedCount() const {
+        std::size_t cached = 0;
+        for (std::size_t cpu = 0; cpu < cpuCount; ++cpu) {
+            cached += __atomic_load_n(&reinterpret_cast<per_cpu_detail::CpuCacheHeader*>(caches + cpu * cacheStride)->count,
+                                      __ATOMIC_RELAXED);
+        }
+        return cached;
+    }
+
+    // Blocks still in the central pool
+    std::size_t getCentralAvailableCount() {
+        std::lock_guard<std::mutex> lock(centralMutex);
+        return central.pool.getAvailableCount();
+    }
+};
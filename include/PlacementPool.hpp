@@ -0,0 +1,314 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "BitmapPool.hpp"
+
+// Geometry a placement policy works on: blocks are numbered page by page
+struct PlacementLayout {
+    std::size_t capacity;
+    std::size_t blocksPerPage;
+    std::size_t pageCount;
+};
+
+// Most recently freed block first: hot in cache, but under a random free
+// order consecutive allocations land on unrelated pages
+class LifoPlacement {
+private:
+    std::vector<std::uint32_t> stack;
+
+public:
+    explicit LifoPlacement(const PlacementLayout& layout) {
+        stack.reserve(layout.capacity);
+        for (std::size_t i = layout.capacity; i > 0; --i) {
+            stack.push_back(static_cast<std::uint32_t>(i - 1));
+        }
+    }
+
+    std::uint32_t take() {
+        std::uint32_t index = stack.back();
+        stack.pop_back();
+        return index;
+    }
+
+    void put(std::uint32_t index) {
+        stack.push_back(index);
+    }
+};
+
+// Lowest free block first, so live blocks stay packed at the start of the slab
+class AddressOrderedPlacement {
+private:
+    std::vector<std::uint64_t> freeBits;
+    std::size_t searchStart = 0; // No word below this one has a free block
+
+public:
+    explicit AddressOrderedPlacement(const PlacementLayout& layout)
+        : freeBits((layout.capacity + 63) / 64, ~std::uint64_t(0)) {
+        if (layout.capacity % 64 != 0) {
+            freeBits.back() = (std::uint64_t(1) << (layout.capacity % 64)) - 1;
+        }
+    }
+
+    std::uint32_t take() {
+        searchStart = bitmap_pool_detail::findNonZero(freeBits.data(), searchStart, freeBits.size());
+        std::uint64_t& word = freeBits[searchStart];
+        std::size_t bit = bitmap_pool_detail::lowestBit(word);
+        word &= word - 1;
+        return static_cast<std::uint32_t>(searchStart * 64 + bit);
+    }
+
+    void put(std::uint32_t index) {
+        freeBits[index / 64] |= std::uint64_t(1) << (index % 64);
+        if (index / 64 < searchStart) {
+            searchStart = index / 64;
+        }
+    }
+};
+
+// Takes from the page with the fewest free blocks, so partly used pages fill
+// up and mostly free ones drain. Pages are kept in buckets by free count;
+// within a page, the most recently freed block goes first.
+class FullestPagePlacement {
+private:
+    static constexpr std::uint32_t none = ~std::uint32_t(0);
+
+    std::size_t blocksPerPage;
+    std::vector<std::vector<std::uint32_t>> pageFree; // Free blocks of each page
+    std::vector<std::uint32_t> bucketHead; // First page with that many free blocks
+    std::vector<std::uint32_t> nextPage;
+    std::vector<std::uint32_t> prevPage;
+    std::size_t lowestBucket; // No non-empty bucket in [1, lowestBucket)
+
+    void link(std::uint32_t page) {
+        std::size_t bucket = pageFree[page].size();
+        prevPage[page] = none;
+        nextPage[page] = bucketHead[bucket];
+        if (bucketHead[bucket] != none) {
+            prevPage[bucketHead[bucket]] = page;
+        }
+        bucketHead[bucket] = page;
+    }
+
+    void unlink(std::uint32_t page) {
+        std::size_t bucket = pageFree[page].size();
+        if (prevPage[page] != none) {
+            nextPage[prevPage[page]] = nextPage[page];
+        } else {
+            bucketHead[bucket] = nextPage[page];
+        }
+        if (nextPage[page] != none) {
+            prevPage[nextPage[page]] = prevPage[page];
+        }
+    }
+
+public:
+    explicit FullestPagePlacement(const PlacementLayout& layout)
+        : blocksPerPage(layout.blocksPerPage),
+          pageFree(layout.pageCount),
+          bucketHead(layout.blocksPerPage + 1, none),
+          nextPage(layout.pageCount, none),
+          prevPage(layout.pageCount, none),
+          lowestBucket(layout.blocksPerPage) {
+        for (std::size_t page = layout.pageCount; page > 0; --page) {
+            std::size_t first = (page - 1) * blocksPerPage;
+            std::size_t last = first + blocksPerPage < layout.capacity ? first + blocksPerPage : layout.capacity;
+            for (std::size_t index = last; index > first; --index) {
+                pageFree[page - 1].push_back(static_cast<std::uint32_t>(index - 1));
+            }
+            link(static_cast<std::uint32_t>(page - 1));
+            if (pageFree[page - 1].size() < lowestBucket) {
+                lowestBucket = pageFree[page - 1].size();
+            }
+        }
+    }
+
+    std::uint32_t take() {
+        while (bucketHead[lowestBucket] == none) {
+            ++lowestBucket;
+        }
+        std::uint32_t page = bucketHead[lowestBucket];
+        unlink(page);
+        std::uint32_t index = pageFree[page].back();
+        pageFree[page].pop_back();
+        if (!pageFree[page].empty()) {
+            link(page);
+            lowestBucket = pageFree[page].size();
+        }
+        return index;
+    }
+
+    void put(std::uint32_t index) {
+        std::uint32_t page = static_cast<std::uint32_t>(index / blocksPerPage);
+        if (!pageFree[page].empty()) {
+            unlink(page);
+        }
+        pageFree[page].push_back(index);
+        link(page);
+        if (pageFree[page].size() < lowestBucket) {
+            lowestBucket = pageFree[page].size();
+        }
+    }
+};
+
+// Fixed-size block pool over one mmap'd slab with a pluggable placement
+// policy deciding which free block an allocation gets: LifoPlacement,
+// AddressOrderedPlacement or FullestPagePlacement. The slab is split into
+// pages of a power-of-two size; with cache coloring, the blocks of
+// consecutive pages start at different cache-line offsets within the page's
+// slack, so the same block of every page does not map to the same cache
+// sets. Like MemoryPool, it is meant for use from one thread.
+template <typename Placement = LifoPlacement>
+class PlacementPool {
+public:
+    static constexpr std::size_t cacheLine = 64;
+
+private:
+    unsigned char* slab = nullptr;
+    std::size_t blockSize;
+    std::size_t stride;
+    std::size_t capacity;
+    std::size_t pageBytes;
+    std::size_t blocksPerPage;
+    std::size_t pageCount;
+    std::size_t colorCount = 1;
+    std::size_t slabBytes;
+    std::size_t freeCount;
+    std::vector<std::uint32_t> pageLive;
+    std::size_t pagesInUse = 0;
+    Placement placement;
+
+    static std::size_t systemPageSize() {
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static std::size_t pageBytesFor(std::size_t stride) {
+        std::size_t bytes = systemPageSize();
+        while (bytes < stride) {
+            bytes *= 2;
+        }
+        return bytes;
+    }
+
+    static std::size_t strideFor(std::size_t blockSize, std::size_t capacity) {
+        if (blockSize == 0 || capacity == 0 || capacity > ~std::uint32_t(0)) {
+            throw std::invalid_argument("PlacementPool: blockSize or capacity out of range");
+        }
+        return (blockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    }
+
+    static PlacementLayout layoutFor(std::size_t blockSize, std::size_t capacity) {
+        std::size_t stride = strideFor(blockSize, capacity);
+        std::size_t perPage = pageBytesFor(stride) / stride;
+        return PlacementLayout{capacity, perPage, (capacity + perPage - 1) / perPage};
+    }
+
+    unsigned char* pageStart(std::size_t page) const {
+        return slab + page * pageBytes + (page % colorCount) * cacheLine;
+    }
+
+public:
+    PlacementPool(std::size_t blockSize, std::size_t capacity, bool cacheColoring = false)
+        : blockSize(blockSize),
+          stride(strideFor(blockSize, capacity)),
+          capacity(capacity),
+          pageBytes(pageBytesFor(stride)),
+          blocksPerPage(pageBytes / stride),
+          pageCount((capacity + blocksPerPage - 1) / blocksPerPage),
+          slabBytes(pageCount * pageBytes),
+          freeCount(capacity),
+          pageLive(pageCount, 0),
+          placement(layoutFor(blockSize, capacity)) {
+        if (cacheColoring) {
+            colorCount = (pageBytes - blocksPerPage * stride) / cacheLine + 1;
+        }
+        void* memory = ::mmap(nullptr, slabBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        slab = static_cast<unsigned char*>(memory);
+    }
+
+    ~PlacementPool() {
+        ::munmap(slab, slabBytes);
+    }
+
+    PlacementPool(const PlacementPool&) = delete;
+    PlacementPool& operator=(const PlacementPool&) = delete;
+
+    void* allocate() {
+        if (freeCount == 0) {
+            throw std::bad_alloc();
+        }
+        std::uint32_t index = placement.take();
+        --freeCount;
+        std::size_t page = index / blocksPerPage;
+        if (pageLive[page]++ == 0) {
+            ++pagesInUse;
+        }
+        return blockAt(index);
+    }
+
+    void deallocate(void* block) {
+        std::uint32_t index = blockIndex(block);
+        std::size_t page = index / blocksPerPage;
+        if (--pageLive[page] == 0) {
+            --pagesInUse;
+        }
+        ++freeCount;
+        placement.put(index);
+    }
+
+    void* blockAt(std::uint32_t index) const {
+        return pageStart(index / blocksPerPage) + (index % blocksPerPage) * stride;
+    }
+
+    std::uint32_t blockIndex(const void* block) const {
+        std::size_t offset = static_cast<std::size_t>(static_cast<const unsigned char*>(block) - slab);
+        std::size_t page = offset / pageBytes; // pageBytes is a power of two
+        std::size_t inPage = offset - page * pageBytes - (page % colorCount) * cacheLine;
+        return static_cast<std::uint32_t>(page * blocksPerPage + inPage / stride);
+    }
+
+    bool hasAvailableMemory() const {
+        return freeCount != 0;
+    }
+
+    std::size_t getBlockSize() const {
+        return blockSize;
+    }
+
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+
+    std::size_t getAvailableCount() const {
+        return freeCount;
+    }
+
+    std::size_t getPageBytes() const {
+        return pageBytes;
+    }
+
+    std::size_t getBlocksPerPage() const {
+        return blocksPerPage;
+    }
+
+    // Distinct starting offsets used by cache coloring; 1 when disabled
+    std::size_t getColorCount() const {
+        return colorCount;
+    }
+
+    // Pages holding at least one live block
+    std::size_t getPagesInUse() const {
+        return pagesInUse;
+    }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new> // For std::bad_alloc
+
+#include "MemoryPool.hpp"
+#include "SizeClassedPool.hpp"
+
+// Standard allocator over pool memory. Bound to a single MemoryPool, every
+// request must fit one block. Bound to a SizeClassedPool, each rebound type
+// (e.g. a container's internal node) is served by the pool for its own size.
+template <typename T>
+class PoolAllocator {
+private:
+    template <typename U>
+    friend class PoolAllocator;
+
+    MemoryPool* pool;
+    SizeClassedPool* classes;
+
+public:
+    using value_type = T;
+
+    PoolAllocator(MemoryPool& pool) : pool(&pool), classes(nullptr) {}
+
+    PoolAllocator(SizeClassedPool& classes) : pool(nullptr), classes(&classes) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : pool(other.pool), classes(other.classes) {}
+
+    T* allocate(std::size_t n) {
+        if (n == 0) {
+            return nullptr; // Return null pointer for zero elements
+        }
+
+        if (classes != nullptr) {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(classes->allocate(n * sizeof(T)));
+        }
+
+        // A request must fit in a single block
+        if (n > pool->getBlockSize() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+
+        // Check if there's enough memory
+        if (!pool->hasAvailableMemory()) {
+            throw std::bad_alloc(); // No memory available, throw exception
+        }
+
+        void* memory = pool->allocate();
+        return static_cast<T*>(memory); // Allocate memory from the pool
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        if (classes != nullptr) {
+            classes->deallocate(p, n * sizeof(T));
+            return;
+        }
+        pool->deallocate(p); // Deallocate memory to the pool
+    }
+
+    // Pool that serves single objects of type T
+    MemoryPool& getPool() const {
+        return classes != nullptr ? classes->poolFor(sizeof(T)) : *pool;
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const {
+        return pool == other.pool && classes == other.classes;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const {
+        return !(*this == other);
+    }
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+#include "PoolAllocator.hpp"
+#include "SizeClassedPool.hpp"
+
+// Node-based standard containers whose nodes come from a SizeClassedPool.
+// Construct them with the pool: pool_map<int, int> m(PoolAllocator<...>(pools))
+// or simply pool_map<int, int> m(pools) via the implicit allocator conversion.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+using pool_map = std::map<Key, Value, Compare, PoolAllocator<std::pair<const Key, Value>>>;
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+using pool_unordered_map =
+    std::unordered_map<Key, Value, Hash, KeyEqual, PoolAllocator<std::pair<const Key, Value>>>;
+
+template <typename T>
+using pool_list = std::list<T, PoolAllocator<T>>;
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional> // For std::function
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new> // For std::bad_alloc
+#include <utility>
+#include <vector>
+
+#include "DeferredDestroyer.hpp"
+#include "MemoryPool.hpp"
+#include "ThreadRegistry.hpp"
+
+// Variadic templates with perfect forwarding. Pool is MemoryPool or any pool
+// with the same getBlockSize/allocate/deallocate interface.
+template <typename T, typename Pool, typename... Args>
+std::unique_ptr<T, std::function<void(T*)>> make_unique_pool(Pool& pool, Args&&... args) {
+    // An object must fit in a single block
+    if (sizeof(T) > pool.getBlockSize()) {
+        throw std::bad_alloc();
+    }
+
+    // Define the deleter as a lambda
+    auto deleter = [&pool](T* ptr) {
+        ptr->~T(); // Call the destructor explicitly
+        pool.deallocate(ptr); // Deallocate the memory back to the pool
+    };
+
+    // Allocate memory from the pool
+    void* memory = pool.allocate();
+
+    // Use placement new to construct the object in the allocated memory
+    T* ptr;
+    try {
+        ptr = new (memory) T(std::forward<Args>(args)...);
+    } catch (...) {
+        pool.deallocate(memory); // Constructor threw, hand the block back
+        throw;
+    }
+
+    // Return a unique_ptr, ensuring the deleter is properly passed
+    return std::unique_ptr<T, std::function<void(T*)>>(ptr, deleter);
+}
+
+// Where a PoolManager block came from
+enum class PoolTier : unsigned char {
+    threadCache, // Central blocks kept by the allocating thread
+    central, // The manager's MemoryPool
+    overflow, // Chunks added on demand once the central pool is empty
+    heap // One malloc per block
+};
+
+// Tiers a PoolManager falls back to, in order, instead of throwing when the
+// central pool runs dry. The central pool is always part of the chain.
+struct FallbackChain {
+    std::size_t threadCacheBlocks = 0; // Blocks each thread may keep; 0 skips the tier
+    std::size_t overflowChunkBlocks = 0; // Blocks per overflow chunk; 0 skips the tier
+    std::size_t overflowMaxChunks = std::numeric_limits<std::size_t>::max();
+    bool heap = false; // Last resort before std::bad_alloc
+};
+
+namespace pool_manager_detail {
+
+struct ThreadCache {
+    std::vector<void*> blocks;
+    std::size_t hits = 0; // Not yet published to the owner
+};
+
+} // namespace pool_manager_detail
+
+// RAII class: automatically manages resources. By default the manager hands
+// out blocks from its MemoryPool and is meant for use from one thread. With a
+// FallbackChain, the pool becomes the contiguous central tier of a chain, and
+// deallocate() routes each block back by address: central blocks are a range
+// check, overflow chunks a binary search, anything else came from malloc. A
+// chain with a thread cache may be shared between threads; its other tiers
+// are then guarded by a mutex that the thread cache mostly avoids.
+class PoolManager {
+public:
+    MemoryPool pool;
+
+private:
+    using Registry = ThreadRegistry<PoolManager, pool_manager_detail::ThreadCache>;
+    friend Registry;
+
+    FallbackChain chain;
+    bool chained = false;
+    std::uint64_t id = 0; // Registered only when shared
+    std::mutex mutex; // Taken only when the chain has a thread cache
+    std::size_t stride;
+    std::vector<unsigned char*> overflowChunks; // Sorted by address
+    std::vector<void*> overflowFree;
+    std::size_t tierHits[4] = {};
+
+    bool shared() const {
+        return chain.threadCacheBlocks > 0;
+    }
+
+    std::unique_lock<std::mutex> lockIfShared() {
+        return shared() ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+    }
+
+    // This thread's cache, or null if it never used this manager
+    pool_manager_detail::ThreadCache* findLocalCache() {
+        return Registry::find(id);
+    }
+
+    pool_manager_detail::ThreadCache& localCache() {
+        if (pool_manager_detail::ThreadCache* cache = findLocalCache()) {
+            return *cache;
+        }
+        pool_manager_detail::ThreadCache cache;
+        cache.blocks.reserve(chain.threadCacheBlocks + 1);
+        return Registry::attach(id, this, std::move(cache));
+    }
+
+    // Thread exit: the cache goes back to the central pool
+    void detachThread(pool_manager_detail::ThreadCache& cache) {
+        std::lock_guard<std::mutex> lock(mutex);
+        drain(cache, 0);
+    }
+
+    // Mutex held when shared
+    void* allocateFromTiers() {
+        if (pool.hasAvailableMemory()) {
+            ++tierHits[static_cast<int>(PoolTier::central)];
+            return pool.allocate();
+        }
+        if (chain.overflowChunkBlocks > 0) {
+            if (overflowFree.empty() && overflowChunks.size() < chain.overflowMaxChunks) {
+                addOverflowChunk();
+            }
+            if (!overflowFree.empty()) {
+                void* block = overflowFree.back();
+                overflowFree.pop_back();
+                ++tierHits[static_cast<int>(PoolTier::overflow)];
+                return block;
+            }
+        }
+        if (chain.heap) {
+            void* block = std::malloc(pool.getBlockSize());
+            if (block != nullptr) {
+                ++tierHits[static_cast<int>(PoolTier::heap)];
+                return block;
+            }
+        }
+        throw std::bad_alloc();
+    }
+
+    void addOverflowChunk() {
+        auto* chunk = static_cast<unsigned char*>(std::malloc(stride * chain.overflowChunkBlocks));
+        if (chunk == nullptr) {
+            return; // Fall through to the next tier
+        }
+        overflowChunks.insert(std::upper_bound(overflowChunks.begin(), overflowChunks.end(), chunk), chunk);
+        for (std::size_t i = chain.overflowChunkBlocks; i > 0; --i) {
+            overflowFree.push_back(chunk + (i - 1) * stride);
+        }
+    }
+
+    bool inOverflow(const void* block) const {
+        auto address = static_cast<const unsigned char*>(block);
+        auto next = std::upper_bound(overflowChunks.begin(), overflowChunks.end(), address);
+        return next != overflowChunks.begin() && address < *(next - 1) + stride * chain.overflowChunkBlocks;
+    }
+
+    // Takes half a cache's worth of central blocks in one locked step
+    void* refill(pool_manager_detail::ThreadCache& cache) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tierHits[static_cast<int>(PoolTier::threadCache)] += std::exchange(cache.hits, 0);
+        std::size_t batch = std::max<std::size_t>(chain.threadCacheBlocks / 2, 1);
+        while (cache.blocks.size() < batch && pool.hasAvailableMemory()) {
+            cache.blocks.push_back(pool.allocate());
+        }
+        if (cache.blocks.empty()) {
+            return allocateFromTiers();
+        }
+        ++tierHits[static_cast<int>(PoolTier::central)];
+        void* block = cache.blocks.back();
+        cache.blocks.pop_back();
+        return block;
+    }
+
+    // Mutex held
+    void drain(pool_manager_detail::ThreadCache& cache, std::size_t keep) {
+        tierHits[static_cast<int>(PoolTier::threadCache)] += std::exchange(cache.hits, 0);
+        while (cache.blocks.size() > keep) {
+            pool.deallocate(cache.blocks.back());
+            cache.blocks.pop_back();
+        }
+    }
+
+public:
+    PoolManager(std::size_t blockSize, std::size_t capacity)
+        : pool(blockSize, capacity), stride(blockSize) {
+    }
+
+    // Central pool of `capacity` contiguous blocks plus the given fallback tiers
+    PoolManager(std::size_t blockSize, std::size_t capacity, FallbackChain chain)
+        : pool(blockSize, capacity, ContiguousBlocks{}),
+          chain(chain),
+          chained(true),
+          stride((blockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                 alignof(std::max_align_t)) {
+        if (shared()) {
+            id = Registry::registerOwner();
+        }
+    }
+
+    ~PoolManager() {
+        if (shared()) {
+            Registry::unregisterOwner(id);
+            Registry::forget(id);
+        }
+        for (unsigned char* chunk : overflowChunks) {
+            std::free(chunk);
+        }
+    }
+
+    PoolManager(const PoolManager&) = delete;
+    PoolManager& operator=(const PoolManager&) = delete;
+
+    void* allocate() {
+        if (!chained) {
+            void* block = pool.allocate();
+            ++tierHits[static_cast<int>(PoolTier::central)];
+            return block;
+        }
+        if (shared()) {
+            pool_manager_detail::ThreadCache& cache = localCache();
+            if (!cache.blocks.empty()) {
+                ++cache.hits;
+                void* block = cache.blocks.back();
+                cache.blocks.pop_back();
+                return block;
+            }
+            return refill(cache);
+        }
+        return allocateFromTiers();
+    }
+
+    void deallocate(void* block) {
+        if (!chained) {
+            pool.deallocate(block);
+            return;
+        }
+        if (pool.owns(block)) {
+            if (shared()) {
+                pool_manager_detail::ThreadCache& cache = localCache();
+                cache.blocks.push_back(block);
+                if (cache.blocks.size() > chain.threadCacheBlocks) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    drain(cache, chain.threadCacheBlocks / 2);
+                }
+                return;
+            }
+            pool.deallocate(block);
+            return;
+        }
+        std::unique_lock<std::mutex> lock = lockIfShared();
+        if (inOverflow(block)) {
+            overflowFree.push_back(block);
+        } else {
+            std::free(block); // Heap tier
+        }
+    }
+
+    // Tier a live block was allocated from; central blocks sitting in a
+    // thread cache also report central
+    PoolTier tierOf(const void* block) {
+        if (!chained || pool.owns(block)) {
+            return PoolTier::central;
+        }
+        std::unique_lock<std::mutex> lock = lockIfShared();
+        return inOverflow(block) ? PoolTier::overflow : PoolTier::heap;
+    }
+
+    // Allocations served by a tier. Other threads' thread-cache hits are
+    // published when they refill or flush their caches.
+    std::size_t getTierHits(PoolTier tier) {
+        // Never creates a cache: that would take the registry lock under mutex,
+        // the reverse of the order an exiting thread flushes in
+        pool_manager_detail::ThreadCache* cache = shared() ? findLocalCache() : nullptr;
+        std::unique_lock<std::mutex> lock = lockIfShared();
+        if (cache != nullptr) {
+            tierHits[static_cast<int>(PoolTier::threadCache)] += std::exchange(cache->hits, 0);
+        }
+        return tierHits[static_cast<int>(tier)];
+    }
+
+    std::size_t getBlockSize() const {
+        return pool.getBlockSize();
+    }
+
+    std::size_t getOverflowChunkCount() {
+        std::unique_lock<std::mutex> lock = lockIfShared();
+        return overflowChunks.size();
+    }
+
+    template <typename T, typename... Args>
+    std::unique_ptr<T, std::function<void(T*)>> create(Args&&... args) {
+        return make_unique_pool<T>(*this, std::forward<Args>(args)...);
+    }
+
+    // Like create(), but the deleter only queues the object on destroyer
+    template <typename T, typename... Args>
+    std::unique_ptr<T, std::function<void(T*)>> createDeferred(DeferredDestroyer& destroyer, Args&&... args) {
+        return make_unique_deferred<T>(*this, destroyer, std::forward<Args>(args)...);
+    }
+};
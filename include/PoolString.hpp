@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new> // For std::bad_alloc
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "MemoryPool.hpp"
+#include "PoolAllocator.hpp"
+#include "SizeClassedPool.hpp"
+
+// std::string whose heap part comes from a SizeClassedPool. Short strings
+// stay in the object (the standard library's small-string buffer), longer
+// ones take one block of the class that fits. Construct it with the pool:
+// pool_string s("text", pools). Like every basic_string it converts to
+// std::string_view without copying.
+using pool_string = std::basic_string<char, std::char_traits<char>, PoolAllocator<char>>;
+
+class StringArena;
+
+// Allocator that carves from a StringArena and never frees on its own; the
+// memory goes back when the arena is reset or destroyed
+template <typename T>
+class ArenaAllocator {
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    StringArena* arena;
+
+public:
+    using value_type = T;
+
+    ArenaAllocator(StringArena& arena) : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(std::size_t n);
+
+    void deallocate(T*, std::size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return !(*this == other);
+    }
+};
+
+// String built directly in an arena, for request-scoped text
+using arena_string = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+// Bump allocator for request-scoped strings that are never freed one by
+// one. Bytes are carved from chunks taken from a MemoryPool; requests larger
+// than a chunk get one heap allocation of their own. intern() stores each
+// distinct string once and hands out string_views into the arena, so equal
+// strings compare by pointer. reset() at the end of a request gives every
+// chunk back to the pool at once.
+class StringArena {
+private:
+    using InternSet = std::unordered_set<std::string_view, std::hash<std::string_view>,
+                                         std::equal_to<std::string_view>, ArenaAllocator<std::string_view>>;
+
+    MemoryPool chunks;
+    std::vector<void*> usedChunks;
+    std::vector<void*> oversized;
+    unsigned char* cursor = nullptr;
+    unsigned char* limit = nullptr;
+    std::size_t bytesUsed = 0;
+    std::optional<InternSet> interned; // Its nodes live in the arena too
+
+    void* allocateOversized(std::size_t bytes) {
+        oversized.reserve(oversized.size() + 1);
+        void* memory = ::operator new(bytes);
+        oversized.push_back(memory);
+        return memory;
+    }
+
+public:
+    // chunkBytes per chunk, at most maxChunks chunks live at once
+    explicit StringArena(std::size_t chunkBytes = 4096, std::size_t maxChunks = 64)
+        : chunks(chunkBytes, maxChunks) {
+        usedChunks.reserve(maxChunks);
+    }
+
+    ~StringArena() {
+        reset();
+    }
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    // alignment must be a power of two no larger than the fundamental alignment
+    void* allocate(std::size_t bytes, std::size_t alignment = 1) {
+        if (bytes > chunks.getBlockSize()) {
+            bytesUsed += bytes;
+            return allocateOversized(bytes);
+        }
+        auto address = reinterpret_cast<std::uintptr_t>(cursor);
+        std::size_t padding = (alignment - address % alignment) % alignment;
+        if (cursor == nullptr || padding + bytes > static_cast<std::size_t>(limit - cursor)) {
+            void* chunk = chunks.allocate(); // Throws std::bad_alloc past maxChunks
+            usedChunks.push_back(chunk);
+            cursor = static_cast<unsigned char*>(chunk);
+            limit = cursor + chunks.getBlockSize();
+            padding = 0; // Chunks are max_align_t aligned
+        }
+        void* memory = cursor + padding;
+        cursor += padding + bytes;
+        bytesUsed += bytes;
+        return memory;
+    }
+
+    // Copies text into the arena; the view lives until reset()
+    std::string_view copy(std::string_view text) {
+        if (text.empty()) {
+            return std::string_view();
+        }
+        auto* memory = static_cast<char*>(allocate(text.size()));
+        std::memcpy(memory, text.data(), text.size());
+        return std::string_view(memory, text.size());
+    }
+
+    // Like copy(), but equal strings share one copy
+    std::string_view intern(std::string_view text) {
+        if (!interned) {
+            interned.emplace(16, std::hash<std::string_view>(), std::equal_to<std::string_view>(),
+                             ArenaAllocator<std::string_view>(*this));
+        }
+        auto found = interned->find(text);
+        if (found != interned->end()) {
+            return *found;
+        }
+        std::string_view stored = copy(text);
+        interned->insert(stored);
+        return stored;
+    }
+
+    // Invalidates every view, arena_string and pointer handed out so far
+    void reset() {
+        interned.reset();
+        for (void* chunk : usedChunks) {
+            chunks.deallocate(chunk);
+        }
+        usedChunks.clear();
+        for (void* memory : oversized) {
+            ::operator delete(memory);
+        }
+        oversized.clear();
+        cursor = nullptr;
+        limit = nullptr;
+        bytesUsed = 0;
+    }
+
+    std::size_t getChunkCount() const {
+        return usedChunks.size();
+    }
+
+    // Bytes handed out since the last reset, padding excluded
+    std::size_t getBytesUsed() const {
+        return bytesUsed;
+    }
+
+    std::size_t getInternedCount() const {
+        return interned ? interned->size() : 0;
+    }
+};
+
+template <typename T>
+T* ArenaAllocator<T>::allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+        throw std::bad_alloc();
+    }
+    return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+}
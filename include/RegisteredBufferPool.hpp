@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "IoUring.hpp"
+
+// Pool of page-aligned I/O buffers carved from one slab that is registered
+// with an io_uring instance as fixed buffers: block i is fixed buffer index i,
+// so READ_FIXED/WRITE_FIXED skip the per-I/O page pinning. Optionally, part
+// of the pool can be lent to a provided-buffer ring, letting the kernel pick
+// a free block itself when a read completes. Same allocate/deallocate
+// interface as MemoryPool; meant for use from one thread.
+class RegisteredBufferPool {
+public:
+    static constexpr std::size_t maxBuffers = 1u << 14; // Kernel limit on fixed buffers
+
+private:
+    IoUring& ring;
+    unsigned char* slab = nullptr;
+    std::size_t bufferSize;
+    std::size_t capacity;
+    std::vector<std::uint16_t> freeIndexes;
+
+    // Provided-buffer ring, when enabled
+    io_uring_buf_ring* bufRing = nullptr;
+    std::size_t bufRingBytes = 0;
+    unsigned bufRingEntries = 0;
+    std::uint16_t groupId = 0;
+    std::uint16_t bufRingTail = 0;
+    std::size_t providedCount = 0;
+
+    static std::size_t pageSize() {
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    void publish(std::uint16_t index) {
+        // Index the entries by hand: in C++ the header's flexible-array macro
+        // expands to an empty struct member that shifts `bufs` by 8 bytes
+        io_uring_buf* buf = reinterpret_cast<io_uring_buf*>(bufRing) + (bufRingTail & (bufRingEntries - 1));
+        buf->addr = reinterpret_cast<std::uint64_t>(bufferAt(index));
+        buf->len = static_cast<std::uint32_t>(bufferSize);
+        buf->bid = index;
+        ++bufRingTail;
+        __atomic_store_n(&bufRing->tail, bufRingTail, __ATOMIC_RELEASE);
+        ++providedCount;
+    }
+
+public:
+    // bufferSize is rounded up to a whole number of pages
+    RegisteredBufferPool(IoUring& ring, std::size_t bufferSize, std::size_t capacity)
+        : ring(ring),
+          bufferSize((bufferSize + pageSize() - 1) / pageSize() * pageSize()),
+          capacity(capacity) {
+        if (capacity == 0 || capacity > maxBuffers) {
+            throw std::invalid_argument("RegisteredBufferPool: capacity must be 1..16384");
+        }
+        void* memory = ::mmap(nullptr, this->bufferSize * capacity, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        slab = static_cast<unsigned char*>(memory);
+
+        std::vector<iovec> iovecs(capacity);
+        for (std::size_t i = 0; i < capacity; ++i) {
+            iovecs[i] = iovec{slab + i * this->bufferSize, this->bufferSize};
+        }
+        try {
+            ring.registerResource(IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned>(capacity));
+        } catch (...) {
+            ::munmap(slab, this->bufferSize * capacity);
+            throw;
+        }
+
+        // Hand out low indexes first
+        freeIndexes.reserve(capacity);
+        for (std::size_t i = capacity; i > 0; --i) {
+            freeIndexes.push_back(static_cast<std::uint16_t>(i - 1));
+        }
+    }
+
+    ~RegisteredBufferPool() {
+        if (bufRing != nullptr) {
+            io_uring_buf_reg reg{};
+            reg.bgid = groupId;
+            ::syscall(__NR_io_uring_register, ring.descriptor(), IORING_UNREGISTER_PBUF_RING, &reg, 1);
+            ::munmap(bufRing, bufRingBytes);
+        }
+        ::syscall(__NR_io_uring_register, ring.descriptor(), IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        ::munmap(slab, bufferSize * capacity);
+    }
+
+    RegisteredBufferPool(const RegisteredBufferPool&) = delete;
+    RegisteredBufferPool& operator=(const RegisteredBufferPool&) = delete;
+
+    void* allocate() {
+        if (freeIndexes.empty()) {
+            throw std::bad_alloc();
+        }
+        std::uint16_t index = freeIndexes.back();
+        freeIndexes.pop_back();
+        return bufferAt(index);
+    }
+
+    void deallocate(void* block) {
+        freeIndexes.push_back(bufferIndex(block));
+    }
+
+    bool hasAvailableMemory() const {
+        return !freeIndexes.empty();
+    }
+
+    std::size_t getBlockSize() const {
+        return bufferSize;
+    }
+
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+
+    std::size_t getAvailableCount() const {
+        return freeIndexes.size();
+    }
+
+    // Fixed-buffer index of a block; also its buffer id in the provided ring
+    std::uint16_t bufferIndex(const void* block) const {
+        return static_cast<std::uint16_t>((static_cast<const unsigned char*>(block) - slab) / bufferSize);
+    }
+
+    void* bufferAt(std::uint16_t index) const {
+        return slab + static_cast<std::size_t>(index) * bufferSize;
+    }
+
+    // Offset -1 reads or writes at the current position (pipes, sockets)
+    void prepareReadFixed(io_uring_sqe* sqe, int fd, void* block, unsigned length, std::uint64_t offset) const {
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<std::uint64_t>(block);
+        sqe->len = length;
+        sqe->off = offset;
+        sqe->buf_index = bufferIndex(block);
+    }
+
+    void prepareWriteFixed(io_uring_sqe* sqe, int fd, const void* block, unsigned length,
+                           std::uint64_t offset) const {
+        sqe->opcode = IORING_OP_WRITE_FIXED;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<std::uint64_t>(block);
+        sqe->len = length;
+        sqe->off = offset;
+        sqe->buf_index = bufferIndex(block);
+    }
+
+    // Registers a provided-buffer ring for buffer group `group`; entries must
+    // be a power of two. Blocks join the ring through provide().
+    void enableProvidedBuffers(std::uint16_t group, unsigned entries) {
+        if (bufRing != nullptr) {
+            throw std::logic_error("RegisteredBufferPool: provided buffers already enabled");
+        }
+        if (entries == 0 || (entries & (entries - 1)) != 0 || entries > 32768) {
+            throw std::invalid_argument("RegisteredBufferPool: ring entries must be a power of two");
+        }
+        std::size_t bytes = (entries * sizeof(io_uring_buf) + pageSize() - 1) / pageSize() * pageSize();
+        void* memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<std::uint64_t>(memory);
+        reg.ring_entries = entries;
+        reg.bgid = group;
+        try {
+            ring.registerResource(IORING_REGISTER_PBUF_RING, &reg, 1);
+        } catch (...) {
+            ::munmap(memory, bytes);
+            throw;
+        }
+        bufRing = static_cast<io_uring_buf_ring*>(memory);
+        bufRingBytes = bytes;
+        bufRingEntries = entries;
+        groupId = group;
+    }
+
+    // Moves up to count free blocks into the provided ring; returns how many
+    std::size_t provide(std::size_t count) {
+        std::size_t moved = 0;
+        while (moved < count && !freeIndexes.empty() && providedCount < bufRingEntries) {
+            publish(freeIndexes.back());
+            freeIndexes.pop_back();
+            ++moved;
+        }
+        return moved;
+    }
+
+    // Read where the kernel picks a block from the provided ring
+    void prepareReadProvided(io_uring_sqe* sqe, int fd, unsigned length, std::uint64_t offset) const {
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = 0;
+        sqe->len = length;
+        sqe->off = offset;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = groupId;
+    }
+
+    // Block the kernel filled for a completion, now owned by the caller;
+    // nullptr if the completion carried no buffer
+    void* takeProvided(const io_uring_cqe& cqe) {
+        if ((cqe.flags & IORING_CQE_F_BUFFER) == 0) {
+            return nullptr;
+        }
+        --providedCount;
+        return bufferAt(static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+    }
+
+    // Returns a block taken from a completion to the provided ring
+    void reprovide(void* block) {
+        if (providedCount >= bufRingEntries) {
+            deallocate(block);
+            return;
+        }
+        publish(bufferIndex(block));
+    }
+
+    std::size_t getProvidedCount() const {
+        return providedCount;
+    }
+};
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Growable pool whose blocks may move. Callers hold Handles instead of
+// pointers; get() resolves a handle to the block's current address, valid
+// until the next compactStep(). The pool grows one chunk at a time, and the
+// incremental compactor drains sparse chunks into fuller ones so the emptied
+// chunks can be returned to the system. Objects are moved with the relocation
+// hook (memcpy by default, i.e. trivially relocatable types). Like
+// MemoryPool, it is meant for use from one thread.
+class RelocatablePool {
+public:
+    // Moves the object at `from` into the uninitialized block `to`
+    using Relocator = std::function<void(void* from, void* to, std::size_t blockSize)>;
+
+    struct Handle {
+        std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t generation = 0;
+
+        explicit operator bool() const {
+            return index != std::numeric_limits<std::uint32_t>::max();
+        }
+
+        bool operator==(const Handle& other) const {
+            return index == other.index && generation == other.generation;
+        }
+
+        bool operator!=(const Handle& other) const {
+            return !(*this == other);
+        }
+    };
+
+private:
+    static constexpr std::uint32_t noHandle = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t noChunk = std::numeric_limits<std::size_t>::max();
+
+    struct Chunk {
+        unsigned char* memory;
+        std::vector<std::uint32_t> freeSlots;
+        std::vector<std::uint32_t> slotHandle; // Owning handle per slot, noHandle if free
+        std::size_t live = 0;
+    };
+
+    struct HandleEntry {
+        void* block = nullptr;
+        std::uint32_t chunk = 0;
+        std::uint32_t slot = 0;
+        std::uint32_t generation = 0;
+        std::uint32_t nextFree = noHandle;
+    };
+
+    std::size_t blockSize;
+    std::size_t stride;
+    std::size_t blocksPerChunk;
+    std::size_t maxChunks;
+    Relocator relocate;
+    double compactionThreshold = 0.25;
+
+    std::vector<std::unique_ptr<Chunk>> chunks; // Released chunks leave a null slot
+    std::vector<HandleEntry> handles;
+    std::uint32_t freeHandle = noHandle;
+    std::size_t liveCount = 0;
+    std::size_t chunkCount = 0;
+    std::size_t allocationChunk = noChunk; // Chunk new blocks come from
+    std::size_t sourceChunk = noChunk; // Chunk being drained by the compactor
+    std::size_t sourceCursor = 0;
+
+    void releaseChunk(std::size_t index) {
+        std::free(chunks[index]->memory);
+        chunks[index].reset();
+        --chunkCount;
+        if (allocationChunk == index) {
+            allocationChunk = noChunk;
+        }
+        if (sourceChunk == index) {
+            sourceChunk = noChunk;
+        }
+    }
+
+    std::size_t addChunk() {
+        if (chunkCount >= maxChunks) {
+            throw std::bad_alloc();
+        }
+        auto chunk = std::make_unique<Chunk>();
+        chunk->memory = static_cast<unsigned char*>(std::malloc(stride * blocksPerChunk));
+        if (chunk->memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        chunk->slotHandle.assign(blocksPerChunk, noHandle);
+        chunk->freeSlots.reserve(blocksPerChunk);
+        for (std::size_t slot = blocksPerChunk; slot > 0; --slot) {
+            chunk->freeSlots.push_back(static_cast<std::uint32_t>(slot - 1));
+        }
+
+        std::size_t index = 0;
+        while (index < chunks.size() && chunks[index]) {
+            ++index;
+        }
+        if (index == chunks.size()) {
+            chunks.push_back(std::move(chunk));
+        } else {
+            chunks[index] = std::move(chunk);
+        }
+        ++chunkCount;
+        return index;
+    }
+
+    // Fullest chunk that still has room, so sparse chunks are left to drain
+    std::size_t pickChunk(std::size_t exclude) const {
+        std::size_t best = noChunk;
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            if (i == exclude || !chunks[i] || chunks[i]->freeSlots.empty()) {
+                continue;
+            }
+            if (best == noChunk || chunks[i]->live > chunks[best]->live) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Takes a free slot outside `exclude`, growing the pool if allowed
+    std::pair<std::size_t, std::uint32_t> takeSlot(std::size_t exclude) {
+        if (allocationChunk == noChunk || allocationChunk == exclude ||
+            chunks[allocationChunk]->freeSlots.empty()) {
+            allocationChunk = pickChunk(exclude);
+            if (allocationChunk == noChunk) {
+                allocationChunk = addChunk();
+            }
+        }
+        Chunk& chunk = *chunks[allocationChunk];
+        std::uint32_t slot = chunk.freeSlots.back();
+        chunk.freeSlots.pop_back();
+        ++chunk.live;
+        return {allocationChunk, slot};
+    }
+
+    void* slotAddress(std::size_t chunk, std::uint32_t slot) const {
+        return chunks[chunk]->memory + slot * stride;
+    }
+
+    void freeSlot(std::size_t chunk, std::uint32_t slot) {
+        Chunk& owner = *chunks[chunk];
+        owner.slotHandle[slot] = noHandle;
+        owner.freeSlots.push_back(slot);
+        --owner.live;
+    }
+
+    bool hasRoomOutside(std::size_t chunk) const {
+        return getAvailableCount() > chunks[chunk]->freeSlots.size();
+    }
+
+    // Sparsest non-empty chunk under the threshold whose blocks fit elsewhere
+    std::size_t pickSource() const {
+        std::size_t freeElsewhere = (chunkCount * blocksPerChunk) - liveCount;
+        std::size_t best = noChunk;
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            if (!chunks[i] || chunks[i]->live == 0) {
+                continue;
+            }
+            double occupancy = static_cast<double>(chunks[i]->live) / static_cast<double>(blocksPerChunk);
+            std::size_t freeOutside = freeElsewhere - chunks[i]->freeSlots.size();
+            if (occupancy > compactionThreshold || freeOutside < chunks[i]->live) {
+                continue;
+            }
+            if (best == noChunk || chunks[i]->live < chunks[best]->live) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+public:
+    RelocatablePool(std::size_t blockSize, std::size_t blocksPerChunk,
+                    std::size_t maxChunks = std::numeric_limits<std::size_t>::max(),
+                    Relocator relocate = [](void* from, void* to, std::size_t size) { std::memcpy(to, from, size); })
+        : blockSize(blockSize),
+          stride((blockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t)),
+          blocksPerChunk(blocksPerChunk),
+          maxChunks(maxChunks),
+          relocate(std::move(relocate)) {
+        if (blocksPerChunk == 0 || blocksPerChunk > noHandle) {
+            throw std::invalid_argument("RelocatablePool: blocksPerChunk out of range");
+        }
+    }
+
+    ~RelocatablePool() {
+        for (std::unique_ptr<Chunk>& chunk : chunks) {
+            if (chunk) {
+                std::free(chunk->memory);
+            }
+        }
+    }
+
+    RelocatablePool(const RelocatablePool&) = delete;
+    RelocatablePool& operator=(const RelocatablePool&) = delete;
+
+    Handle allocate() {
+        // Keep new blocks out of the chunk being drained while there is room elsewhere
+        if (sourceChunk != noChunk && !hasRoomOutside(sourceChunk)) {
+            sourceChunk = noChunk;
+        }
+        auto [chunk, slot] = takeSlot(sourceChunk);
+
+        std::uint32_t index = freeHandle;
+        if (index == noHandle) {
+            index = static_cast<std::uint32_t>(handles.size());
+            handles.emplace_back();
+        } else {
+            freeHandle = handles[index].nextFree;
+        }
+        HandleEntry& entry = handles[index];
+        entry.block = slotAddress(chunk, slot);
+        entry.chunk = static_cast<std::uint32_t>(chunk);
+        entry.slot = slot;
+        chunks[chunk]->slotHandle[slot] = index;
+        ++liveCount;
+        return Handle{index, entry.generation};
+    }
+
+    void deallocate(Handle handle) {
+        if (get(handle) == nullptr) {
+            throw std::invalid_argument("RelocatablePool: stale or invalid handle");
+        }
+        HandleEntry& entry = handles[handle.index];
+        freeSlot(entry.chunk, entry.slot);
+        entry.block = nullptr;
+        ++entry.generation; // Outstanding copies of the handle go stale
+        entry.nextFree = freeHandle;
+        freeHandle = handle.index;
+        --liveCount;
+    }
+
+    // Current address of the block, or nullptr for a stale handle
+    void* get(Handle handle) const {
+        if (handle.index >= handles.size() || handles[handle.index].generation != handle.generation) {
+            return nullptr;
+        }
+        return handles[handle.index].block;
+    }
+
+    template <typename T>
+    T* get(Handle handle) const {
+        return static_cast<T*>(get(handle));
+    }
+
+    // Chunks at or below this occupancy (0..1) are drained by the compactor
+    void setCompactionThreshold(double occupancy) {
+        compactionThreshold = occupancy;
+    }
+
+    // One bounded increment of compaction: examines at most `budget` slots of
+    // the chunk being drained, relocating the live ones, and releases chunks
+    // that end up empty. Apart from that, a step only scans the chunk table.
+    // Returns the number of blocks moved.
+    std::size_t compactStep(std::size_t budget) {
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            if (chunks[i] && chunks[i]->live == 0 && chunkCount > 1) {
+                releaseChunk(i);
+            }
+        }
+        if (sourceChunk == noChunk) {
+            sourceChunk = pickSource();
+            sourceCursor = 0;
+            if (sourceChunk == noChunk) {
+                return 0;
+            }
+        }
+
+        std::size_t moved = 0;
+        Chunk* source = chunks[sourceChunk].get();
+        for (; budget > 0 && sourceCursor < blocksPerChunk && source->live > 0 && hasRoomOutside(sourceChunk);
+             --budget, ++sourceCursor) {
+            std::uint32_t slot = static_cast<std::uint32_t>(sourceCursor);
+            std::uint32_t owner = source->slotHandle[slot];
+            if (owner == noHandle) {
+                continue;
+            }
+            auto [chunk, target] = takeSlot(sourceChunk);
+            void* to = slotAddress(chunk, target);
+            relocate(handles[owner].block, to, blockSize);
+            freeSlot(sourceChunk, slot);
+            chunks[chunk]->slotHandle[target] = owner;
+            handles[owner].block = to;
+            handles[owner].chunk = static_cast<std::uint32_t>(chunk);
+            handles[owner].slot = target;
+            ++moved;
+        }
+        if (source->live == 0) {
+            releaseChunk(sourceChunk);
+        } else if (sourceCursor == blocksPerChunk || !hasRoomOutside(sourceChunk)) {
+            sourceChunk = noChunk; // Nowhere to move the rest: pick again later
+        }
+        return moved;
+    }
+
+    std::size_t getBlockSize() const {
+        return blockSize;
+    }
+
+    std::size_t getBlocksPerChunk() const {
+        return blocksPerChunk;
+    }
+
+    std::size_t getChunkCount() const {
+        return chunkCount;
+    }
+
+    std::size_t getLiveCount() const {
+        return liveCount;
+    }
+
+    std::size_t getCapacity() const {
+        return chunkCount * blocksPerChunk;
+    }
+
+    std::size_t getAvailableCount() const {
+        return getCapacity() - liveCount;
+    }
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "EpochDomain.hpp"
+#include "MemoryPool.hpp"
+
+// Unbounded multi-producer multi-consumer queue built from fixed-size
+// segments, each one block of a pool. Producers and consumers claim cells
+// with a fetch_add on the segment's enqueue and dequeue indices; when a
+// segment fills up, the producer that notices links a fresh one, and the
+// consumer that drains a segment retires it through an EpochDomain, which
+// hands the block back to the pool once no thread can still be reading it.
+// Once the pool holds enough segments for the queue's peak depth, push and
+// pop allocate nothing. The pool's blocks must hold segmentBytes, and the
+// pool must only be touched through the queue while the queue lives; push()
+// throws std::bad_alloc when the pool runs dry.
+template <typename T, std::size_t SlotsPerSegment = 64, typename Pool = MemoryPool>
+class SegmentQueue {
+    static_assert(SlotsPerSegment > 0, "SegmentQueue: a segment needs at least one slot");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "SegmentQueue: pool blocks are only max_align_t aligned");
+
+private:
+    enum : std::uint8_t { empty = 0, ready = 1, abandoned = 2 };
+
+    struct Cell {
+        std::atomic<std::uint8_t> state{empty};
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    struct Segment {
+        std::atomic<std::size_t> enqueueIndex{0};
+        unsigned char padding[64 - sizeof(std::atomic<std::size_t>)]; // Producers and consumers on separate lines
+        std::atomic<std::size_t> dequeueIndex{0};
+        std::atomic<Segment*> next{nullptr};
+        Cell cells[SlotsPerSegment];
+    };
+
+public:
+    // Block size the pool needs
+    static constexpr std::size_t segmentBytes = sizeof(Segment);
+
+private:
+    EpochDomain<Pool> domain;
+    std::atomic<Segment*> head;
+    std::atomic<Segment*> tail;
+
+    static constexpr int allocationAttempts = 64;
+
+    // Called unpinned, so collect() can reclaim drained segments; nullptr
+    // while the pool is dry
+    Segment* tryNewSegment() {
+        try {
+            return new (domain.allocate()) Segment();
+        } catch (const std::bad_alloc&) {
+            domain.collect();
+            return nullptr;
+        }
+    }
+
+    // Moves item into a claimed cell; if a consumer abandoned the cell first,
+    // moves it back and claims another
+    void enqueue(T& item) {
+        Segment* spare = nullptr;
+        int failedAllocations = 0;
+        while (true) {
+            {
+                auto guard = domain.pin();
+                Segment* last = tail.load(std::memory_order_acquire);
+                std::size_t index = last->enqueueIndex.fetch_add(1, std::memory_order_acq_rel);
+                if (index < SlotsPerSegment) {
+                    Cell& cell = last->cells[index];
+                    ::new (static_cast<void*>(cell.storage)) T(std::move(item));
+                    std::uint8_t expected = empty;
+                    if (cell.state.compare_exchange_strong(expected, ready, std::memory_order_acq_rel)) {
+                        break;
+                    }
+                    item = std::move(*cell.value());
+                    cell.value()->~T();
+                    continue;
+                }
+                Segment* next = last->next.load(std::memory_order_acquire);
+                if (next != nullptr) {
+                    tail.compare_exchange_strong(last, next, std::memory_order_acq_rel);
+                    continue;
+                }
+                if (spare != nullptr) {
+                    Segment* expected = nullptr;
+                    if (last->next.compare_exchange_strong(expected, spare, std::memory_order_acq_rel)) {
+                        tail.compare_exchange_strong(last, spare, std::memory_order_acq_rel);
+                        spare = nullptr;
+                    }
+                    continue;
+                }
+            }
+            spare = tryNewSegment();
+            if (spare == nullptr) {
+                // Another producer may link a segment, or a pinned thread may
+                // move on and let drained segments be reclaimed
+                if (++failedAllocations == allocationAttempts) {
+                    throw std::bad_alloc();
+                }
+                std::this_thread::yield();
+            }
+        }
+        if (spare != nullptr) {
+            domain.deallocate(spare); // Another producer linked its segment first
+        }
+    }
+
+public:
+    explicit SegmentQueue(Pool& pool) : domain(pool, 1) {
+        if (pool.getBlockSize() < segmentBytes) {
+            throw std::invalid_argument("SegmentQueue: pool blocks are smaller than segmentBytes");
+        }
+        Segment* first = new (domain.allocate()) Segment();
+        head.store(first, std::memory_order_relaxed);
+        tail.store(first, std::memory_order_relaxed);
+    }
+
+    // No other thread may use the queue any more
+    ~SegmentQueue() {
+        Segment* segment = head.load(std::memory_order_relaxed);
+        while (segment != nullptr) {
+            std::size_t end = segment->enqueueIndex.load(std::memory_order_relaxed);
+            if (end > SlotsPerSegment) {
+                end = SlotsPerSegment;
+            }
+            for (std::size_t i = segment->dequeueIndex.load(std::memory_order_relaxed); i < end; ++i) {
+                if (segment->cells[i].state.load(std::memory_order_relaxed) == ready) {
+                    segment->cells[i].value()->~T();
+                }
+            }
+            Segment* next = segment->next.load(std::memory_order_relaxed);
+            domain.retire(static_cast<void*>(segment));
+            segment = next;
+        }
+    } // The domain returns every segment to the pool
+
+    SegmentQueue(const SegmentQueue&) = delete;
+    SegmentQueue& operator=(const SegmentQueue&) = delete;
+
+    void push(const T& item) {
+        T copy(item);
+        enqueue(copy);
+    }
+
+    void push(T&& item) {
+        enqueue(item);
+    }
+
+    // Returns false when the queue is empty
+    bool tryPop(T& item) {
+        auto guard = domain.pin();
+        while (true) {
+            Segment* first = head.load(std::memory_order_acquire);
+            std::size_t index = first->dequeueIndex.load(std::memory_order_acquire);
+            if (index >= first->enqueueIndex.load(std::memory_order_acquire) &&
+                first->next.load(std::memory_order_acquire) == nullptr) {
+                return false;
+            }
+            index = first->dequeueIndex.fetch_add(1, std::memory_order_acq_rel);
+            if (index < SlotsPerSegment) {
+                Cell& cell = first->cells[index];
+                std::uint8_t expected = empty;
+                if (cell.state.compare_exchange_strong(expected, abandoned, std::memory_order_acq_rel)) {
+                    continue; // Its producer has not written yet and will retry elsewhere
+                }
+                T* value = cell.value();
+                item = std::move(*value);
+                value->~T();
+                return true;
+            }
+            Segment* next = first->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                return false;
+            }
+            Segment* last = first;
+            tail.compare_exchange_strong(last, next, std::memory_order_acq_rel); // Tail must not lag behind a retired segment
+            if (head.compare_exchange_strong(first, next, std::memory_order_acq_rel)) {
+                domain.retire(static_cast<void*>(first)); // Every cell is consumed or abandoned
+            }
+        }
+    }
+
+    static constexpr std::size_t getSlotsPerSegment() {
+        return SlotsPerSegment;
+    }
+
+    // Drained segments handed back to the pool so far
+    std::size_t getRecycledCount() const {
+        return domain.getReclaimedCount();
+    }
+};
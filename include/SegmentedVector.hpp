@@ -0,0 +1,263 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MemoryPool.hpp"
+
+// Append-only-at-the-back sequence whose elements never move. Elements live
+// in fixed-size segments, each exactly one block of a pool; a segment table
+// maps an index to its segment with a shift and a mask, since the number of
+// elements per segment is rounded down to a power of two. push_back() is O(1)
+// and never reallocates or copies elements, so references stay valid until
+// the element is popped. A segment goes back to the pool as soon as
+// pop_back() or clear() empties it.
+template <typename T, typename Pool = MemoryPool>
+class SegmentedVector {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "SegmentedVector: pool blocks are only max_align_t aligned");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+private:
+    Pool* pool;
+    std::vector<T*> segments;
+    std::size_t size_ = 0;
+    std::size_t shift;
+    std::size_t mask;
+
+    static std::size_t shiftFor(const Pool& pool) {
+        std::size_t perBlock = pool.getBlockSize() / sizeof(T);
+        if (perBlock == 0) {
+            throw std::invalid_argument("SegmentedVector: pool blocks are smaller than one element");
+        }
+        std::size_t shift = 0;
+        while ((std::size_t(2) << shift) <= perBlock) {
+            ++shift;
+        }
+        return shift;
+    }
+
+    T* slot(std::size_t index) const {
+        return segments[index >> shift] + (index & mask);
+    }
+
+    template <bool Const>
+    class Iterator {
+    private:
+        using Vector = std::conditional_t<Const, const SegmentedVector, SegmentedVector>;
+
+        Vector* vector = nullptr;
+        std::size_t index = 0;
+
+        friend class SegmentedVector;
+
+        Iterator(Vector* vector, std::size_t index) : vector(vector), index(index) {}
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() = default;
+
+        // Non-const to const conversion
+        template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) : vector(other.vector), index(other.index) {}
+
+        reference operator*() const { return *vector->slot(index); }
+        pointer operator->() const { return vector->slot(index); }
+        reference operator[](difference_type offset) const { return *vector->slot(index + offset); }
+
+        Iterator& operator++() {
+            ++index;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++index;
+            return previous;
+        }
+
+        Iterator& operator--() {
+            --index;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator previous = *this;
+            --index;
+            return previous;
+        }
+
+        Iterator& operator+=(difference_type offset) {
+            index += offset;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type offset) {
+            index -= offset;
+            return *this;
+        }
+
+        friend Iterator operator+(Iterator it, difference_type offset) { return it += offset; }
+        friend Iterator operator+(difference_type offset, Iterator it) { return it += offset; }
+        friend Iterator operator-(Iterator it, difference_type offset) { return it -= offset; }
+
+        friend difference_type operator-(const Iterator& a, const Iterator& b) {
+            return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.index == b.index; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.index != b.index; }
+        friend bool operator<(const Iterator& a, const Iterator& b) { return a.index < b.index; }
+        friend bool operator>(const Iterator& a, const Iterator& b) { return a.index > b.index; }
+        friend bool operator<=(const Iterator& a, const Iterator& b) { return a.index <= b.index; }
+        friend bool operator>=(const Iterator& a, const Iterator& b) { return a.index >= b.index; }
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit SegmentedVector(Pool& pool) : pool(&pool), shift(shiftFor(pool)), mask((std::size_t(1) << shift) - 1) {}
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : pool(other.pool),
+          segments(std::move(other.segments)),
+          size_(std::exchange(other.size_, 0)),
+          shift(other.shift),
+          mask(other.mask) {
+        other.segments.clear();
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& other) noexcept {
+        if (this != &other) {
+            clear();
+            pool = other.pool;
+            segments = std::move(other.segments);
+            other.segments.clear();
+            size_ = std::exchange(other.size_, 0);
+            shift = other.shift;
+            mask = other.mask;
+        }
+        return *this;
+    }
+
+    SegmentedVector(const SegmentedVector&) = delete;
+    SegmentedVector& operator=(const SegmentedVector&) = delete;
+
+    ~SegmentedVector() {
+        clear();
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size_); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Elements held by each segment, a power of two
+    std::size_t segment_capacity() const { return mask + 1; }
+
+    // Segments currently taken from the pool
+    std::size_t segment_count() const { return segments.size(); }
+
+    Pool& get_pool() const {
+        return *pool;
+    }
+
+    T& operator[](std::size_t index) { return *slot(index); }
+    const T& operator[](std::size_t index) const { return *slot(index); }
+
+    T& at(std::size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("SegmentedVector::at");
+        }
+        return *slot(index);
+    }
+
+    const T& at(std::size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("SegmentedVector::at");
+        }
+        return *slot(index);
+    }
+
+    T& front() { return *slot(0); }
+    const T& front() const { return *slot(0); }
+    T& back() { return *slot(size_ - 1); }
+    const T& back() const { return *slot(size_ - 1); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        bool newSegment = (size_ & mask) == 0 && (size_ >> shift) == segments.size();
+        if (newSegment) {
+            // Only the table grows, geometrically; the elements never move
+            segments.push_back(nullptr);
+            try {
+                segments.back() = static_cast<T*>(pool->allocate());
+            } catch (...) {
+                segments.pop_back();
+                throw;
+            }
+        }
+        T* target = slot(size_);
+        try {
+            ::new (static_cast<void*>(target)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            if (newSegment) {
+                pool->deallocate(segments.back());
+                segments.pop_back();
+            }
+            throw;
+        }
+        ++size_;
+        return *target;
+    }
+
+    void push_back(const T& item) {
+        emplace_back(item);
+    }
+
+    void push_back(T&& item) {
+        emplace_back(std::move(item));
+    }
+
+    void pop_back() {
+        --size_;
+        slot(size_)->~T();
+        if ((size_ & mask) == 0) {
+            // The last segment is empty now
+            pool->deallocate(segments.back());
+            segments.pop_back();
+        }
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i < size_; ++i) {
+            slot(i)->~T();
+        }
+        for (T* segment : segments) {
+            pool->deallocate(segment);
+        }
+        segments.clear();
+        size_ = 0;
+    }
+};
+
+template <typename T, typename Pool = MemoryPool>
+using segmented_vector = SegmentedVector<T, Pool>;
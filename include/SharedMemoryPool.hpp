@@ -0,0 +1,265 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "MappedFile.hpp"
+
+// Layout of the first page of a shared segment. All links are offsets from
+// the start of the segment, since every process maps it at its own address.
+struct SharedPoolHeader {
+    static constexpr std::uint64_t expectedMagic = 0x4C4F4F5053504D31ull; // "1MPSPOOL"
+    static constexpr std::uint32_t expectedVersion = 1;
+
+    std::atomic<std::uint64_t> magic; // Published last by the creating process
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint64_t blockSize;
+    std::uint64_t capacity;
+    std::uint64_t dataOffset;
+    std::uint64_t stride;
+    pthread_mutex_t mutex; // Process-shared and robust
+    std::uint64_t freeHead; // Offset of the first free block, 0 when exhausted
+    std::uint64_t freeCount;
+};
+
+// Fixed-size block pool living in a shared-memory segment (shm_open or
+// memfd_create). Any process that maps the segment can allocate a block and
+// any other can free it, so large messages are handed over by sending an
+// offset instead of copying the payload. The free list is guarded by a robust
+// process-shared mutex: if a process dies holding it, the next locker repairs
+// the free list and carries on.
+class SharedMemoryPool {
+private:
+    std::unique_ptr<MappedFile> segment;
+    SharedPoolHeader* header = nullptr;
+
+    static constexpr std::size_t pageSize = 4096;
+
+    unsigned char* base() const {
+        return static_cast<unsigned char*>(segment->data());
+    }
+
+    static std::size_t strideFor(std::size_t blockSize) {
+        return (blockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    }
+
+    static std::size_t dataOffsetFor() {
+        return (sizeof(SharedPoolHeader) + pageSize - 1) / pageSize * pageSize;
+    }
+
+    std::uint64_t linkAt(std::uint64_t offset) const {
+        std::uint64_t next;
+        std::memcpy(&next, base() + offset, sizeof(next));
+        return next;
+    }
+
+    bool isBlockOffset(std::uint64_t offset) const {
+        return offset >= header->dataOffset && offset < header->dataOffset + header->capacity * header->stride &&
+               (offset - header->dataOffset) % header->stride == 0;
+    }
+
+    void initialize(std::size_t blockSize, std::size_t capacity) {
+        if (blockSize < sizeof(std::uint64_t)) {
+            throw std::invalid_argument("SharedMemoryPool: blocks must hold a 64-bit free-list link");
+        }
+        header->version = SharedPoolHeader::expectedVersion;
+        header->headerSize = sizeof(SharedPoolHeader);
+        header->blockSize = blockSize;
+        header->capacity = capacity;
+        header->dataOffset = dataOffsetFor();
+        header->stride = strideFor(blockSize);
+
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+        int rc = pthread_mutex_init(&header->mutex, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+        if (rc != 0) {
+            throw std::system_error(rc, std::generic_category(), "SharedMemoryPool: pthread_mutex_init");
+        }
+
+        for (std::size_t i = 0; i < capacity; ++i) {
+            std::uint64_t offset = header->dataOffset + i * header->stride;
+            std::uint64_t next = i + 1 < capacity ? offset + header->stride : 0;
+            std::memcpy(base() + offset, &next, sizeof(next));
+        }
+        header->freeHead = capacity > 0 ? header->dataOffset : 0;
+        header->freeCount = capacity;
+        header->magic.store(SharedPoolHeader::expectedMagic, std::memory_order_release);
+    }
+
+    void validate() const {
+        if (segment->size() < sizeof(SharedPoolHeader) ||
+            header->magic.load(std::memory_order_acquire) != SharedPoolHeader::expectedMagic ||
+            header->version != SharedPoolHeader::expectedVersion ||
+            segment->size() < header->dataOffset + header->capacity * header->stride) {
+            throw std::runtime_error("SharedMemoryPool: segment does not hold an initialized pool");
+        }
+    }
+
+    // A process died inside allocate or deallocate. Both publish freeHead
+    // last, so at worst the block in flight is lost; keep the valid prefix of
+    // the list and recount it.
+    void repairAfterOwnerDeath() {
+        std::uint64_t count = 0;
+        std::uint64_t* link = &header->freeHead;
+        while (*link != 0) {
+            if (!isBlockOffset(*link) || count == header->capacity) {
+                *link = 0;
+                break;
+            }
+            ++count;
+            link = reinterpret_cast<std::uint64_t*>(base() + *link);
+        }
+        header->freeCount = count;
+    }
+
+    class Lock {
+    private:
+        SharedMemoryPool& pool;
+
+    public:
+        explicit Lock(SharedMemoryPool& pool) : pool(pool) {
+            int rc = pthread_mutex_lock(&pool.header->mutex);
+            if (rc == EOWNERDEAD) {
+                pool.repairAfterOwnerDeath();
+                rc = pthread_mutex_consistent(&pool.header->mutex);
+            }
+            if (rc != 0) {
+                throw std::system_error(rc, std::generic_category(), "SharedMemoryPool: lock");
+            }
+        }
+
+        ~Lock() {
+            pthread_mutex_unlock(&pool.header->mutex);
+        }
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+    };
+
+public:
+    // Creates an anonymous segment (memfd_create). Children created with
+    // fork() share it directly; other processes attach through descriptor()
+    // passed over a Unix socket.
+    SharedMemoryPool(std::size_t blockSize, std::size_t capacity) {
+        int fd = ::memfd_create("mpm-shared-pool", MFD_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "SharedMemoryPool: memfd_create");
+        }
+        segment = std::make_unique<MappedFile>(fd, dataOffsetFor() + strideFor(blockSize) * capacity);
+        header = static_cast<SharedPoolHeader*>(segment->data());
+        initialize(blockSize, capacity);
+    }
+
+    // Creates a named POSIX shared-memory segment; fails if the name exists
+    SharedMemoryPool(const std::string& name, std::size_t blockSize, std::size_t capacity) {
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "SharedMemoryPool: shm_open");
+        }
+        try {
+            segment = std::make_unique<MappedFile>(fd, dataOffsetFor() + strideFor(blockSize) * capacity);
+            header = static_cast<SharedPoolHeader*>(segment->data());
+            initialize(blockSize, capacity);
+        } catch (...) {
+            ::shm_unlink(name.c_str()); // Otherwise the next attempt fails with EEXIST
+            throw;
+        }
+    }
+
+    // Attaches to a named segment created by another process
+    explicit SharedMemoryPool(const std::string& name) {
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "SharedMemoryPool: shm_open");
+        }
+        segment = std::make_unique<MappedFile>(fd, 0);
+        header = static_cast<SharedPoolHeader*>(segment->data());
+        validate();
+    }
+
+    // Attaches to a segment by descriptor, e.g. one received over SCM_RIGHTS;
+    // takes ownership of fd
+    explicit SharedMemoryPool(int fd) {
+        segment = std::make_unique<MappedFile>(fd, 0);
+        header = static_cast<SharedPoolHeader*>(segment->data());
+        validate();
+    }
+
+    SharedMemoryPool(const SharedMemoryPool&) = delete;
+    SharedMemoryPool& operator=(const SharedMemoryPool&) = delete;
+
+    // Removes a named segment; processes still attached keep their mapping
+    static void unlink(const std::string& name) {
+        ::shm_unlink(name.c_str());
+    }
+
+    void* allocate() {
+        Lock lock(*this);
+        std::uint64_t offset = header->freeHead;
+        if (offset == 0) {
+            throw std::bad_alloc();
+        }
+        header->freeHead = linkAt(offset);
+        --header->freeCount;
+        return base() + offset;
+    }
+
+    void deallocate(void* block) {
+        std::uint64_t offset = toOffset(block);
+        Lock lock(*this);
+        std::memcpy(block, &header->freeHead, sizeof(std::uint64_t));
+        header->freeHead = offset;
+        ++header->freeCount;
+    }
+
+    bool hasAvailableMemory() const {
+        return __atomic_load_n(&header->freeHead, __ATOMIC_RELAXED) != 0;
+    }
+
+    std::size_t getBlockSize() const {
+        return static_cast<std::size_t>(header->blockSize);
+    }
+
+    std::size_t getCapacity() const {
+        return static_cast<std::size_t>(header->capacity);
+    }
+
+    std::size_t getAvailableCount() const {
+        return static_cast<std::size_t>(__atomic_load_n(&header->freeCount, __ATOMIC_RELAXED));
+    }
+
+    bool owns(const void* block) const {
+        auto* bytes = static_cast<const unsigned char*>(block);
+        return bytes >= base() + header->dataOffset &&
+               bytes < base() + header->dataOffset + header->capacity * header->stride;
+    }
+
+    // Offsets are what processes exchange: each one maps the segment at its
+    // own address. 0 is the null offset.
+    std::uint64_t toOffset(const void* block) const {
+        return block == nullptr ? 0 : static_cast<std::uint64_t>(static_cast<const unsigned char*>(block) - base());
+    }
+
+    void* fromOffset(std::uint64_t offset) const {
+        return offset == 0 ? nullptr : base() + offset;
+    }
+
+    int descriptor() const {
+        return segment->descriptor();
+    }
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new> // For std::bad_alloc
+#include <vector>
+
+#include "MemoryPool.hpp"
+
+// A family of MemoryPools, one per size class, created on first use.
+// Up to linearLimit, size classes are multiples of the fundamental alignment,
+// so every node type of a container lands in a pool whose blocks fit it
+// exactly. Above that, classes are powers of two and each holds about as many
+// bytes as one linear class, which keeps large arrays such as hash tables
+// pooled without reserving blocksPerClass of them. An array class holds at
+// least two blocks, so a table can keep its old array while it takes the new
+// one, and grows by the same amount from the heap when it runs dry, so several
+// tables or vectors can share it. Linear classes stay bounded and throw
+// std::bad_alloc once empty.
+// Requests larger than maxPooledSize bypass the pools and go to the global heap.
+class SizeClassedPool {
+public:
+    static constexpr std::size_t granularity = alignof(std::max_align_t);
+    static constexpr std::size_t linearLimit = 256;
+    static constexpr std::size_t linearClasses = linearLimit / granularity;
+    static constexpr std::size_t defaultMaxPooledSize = 64 * 1024;
+
+private:
+    std::vector<std::unique_ptr<MemoryPool>> classes;
+    std::size_t blocksPerClass;
+    std::size_t maxPooledSize;
+
+    static std::size_t classIndex(std::size_t bytes) {
+        if (bytes <= linearLimit) {
+            return (bytes - 1) / granularity;
+        }
+        std::size_t index = linearClasses;
+        for (std::size_t size = linearLimit * 2; size < bytes; size *= 2) {
+            ++index;
+        }
+        return index;
+    }
+
+    std::size_t blocksFor(std::size_t classSize) const {
+        if (classSize <= linearLimit) {
+            return blocksPerClass;
+        }
+        std::size_t blocks = blocksPerClass * linearLimit / classSize;
+        return blocks < 2 ? 2 : blocks;
+    }
+
+public:
+    SizeClassedPool(std::size_t blocksPerClass, std::size_t maxPooledSize = defaultMaxPooledSize)
+        : classes(classIndex(roundUp(maxPooledSize)) + 1),
+          blocksPerClass(blocksPerClass),
+          maxPooledSize(roundUp(maxPooledSize)) {
+    }
+
+    SizeClassedPool(const SizeClassedPool&) = delete;
+    SizeClassedPool& operator=(const SizeClassedPool&) = delete;
+
+    // Block size of the class that serves a request of the given size
+    static constexpr std::size_t roundUp(std::size_t bytes) {
+        if (bytes <= linearLimit) {
+            return (bytes + granularity - 1) / granularity * granularity;
+        }
+        std::size_t size = linearLimit * 2;
+        while (size < bytes) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    bool isPooled(std::size_t bytes) const {
+        return bytes != 0 && bytes <= maxPooledSize;
+    }
+
+    // Pool serving requests of the given size; bytes must satisfy isPooled()
+    MemoryPool& poolFor(std::size_t bytes) {
+        std::unique_ptr<MemoryPool>& pool = classes[classIndex(bytes)];
+        if (!pool) {
+            std::size_t classSize = roundUp(bytes);
+            pool = std::make_unique<MemoryPool>(classSize, blocksFor(classSize));
+        }
+        return *pool;
+    }
+
+    void* allocate(std::size_t bytes) {
+        if (!isPooled(bytes)) {
+            return ::operator new(bytes); // Too large for any size class
+        }
+        MemoryPool& pool = poolFor(bytes);
+        if (!pool.hasAvailableMemory() && pool.getBlockSize() > linearLimit) {
+            pool.grow(blocksFor(pool.getBlockSize()));
+        }
+        return pool.allocate();
+    }
+
+    void deallocate(void* block, std::size_t bytes) {
+        if (!isPooled(bytes)) {
+            ::operator delete(block);
+            return;
+        }
+        classes[classIndex(bytes)]->deallocate(block);
+    }
+
+    std::size_t getBlocksPerClass() const {
+        return blocksPerClass;
+    }
+
+    std::size_t getMaxPooledSize() const {
+        return maxPooledSize;
+    }
+};
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "SizeClassedPool.hpp"
+
+// Whether moving a T to a new address and forgetting the old one is a plain
+// memcpy. True for trivially copyable types; specialize it for types such
+// as handles or smart pointers that hold no pointer into themselves.
+template <typename T>
+struct trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+struct trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+
+// Vector with room for N elements inside the object. Beyond that, the
+// elements move to one contiguous block of Pool, any pool with
+// allocate(bytes) and deallocate(block, bytes) such as SizeClassedPool, and
+// later growth moves them to a block twice as large. A SizeClassedPool only
+// pools blocks up to its maxPooledSize (64 KiB by default); larger growth
+// steps go to the global heap. Trivially relocatable
+// elements are moved with memcpy. Moving a vector whose elements live in
+// the pool steals the block, along with the pool it must go back to.
+template <typename T, std::size_t N, typename Pool = SizeClassedPool>
+class SmallVector {
+    static_assert(N > 0, "SmallVector: use a pool vector for no inline storage");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+private:
+    T* data_;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = N;
+    Pool* pool;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+
+    T* inlineData() {
+        return std::launder(reinterpret_cast<T*>(inline_));
+    }
+
+    static void relocate(T* from, std::size_t count, T* to) {
+        if constexpr (trivially_relocatable<T>::value) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+            }
+        } else {
+            // The sources survive until every element is built, so a throwing
+            // copy leaves them as they were
+            std::size_t built = 0;
+            try {
+                for (; built < count; ++built) {
+                    ::new (static_cast<void*>(to + built)) T(std::move_if_noexcept(from[built]));
+                }
+            } catch (...) {
+                while (built > 0) {
+                    to[--built].~T();
+                }
+                throw;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                from[i].~T();
+            }
+        }
+    }
+
+    void releaseBlock() {
+        if (!is_inline()) {
+            pool->deallocate(data_, capacity_ * sizeof(T));
+        }
+    }
+
+    void growTo(std::size_t capacity) {
+        if (capacity > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        T* block = static_cast<T*>(pool->allocate(capacity * sizeof(T)));
+        try {
+            relocate(data_, size_, block);
+        } catch (...) {
+            pool->deallocate(block, capacity * sizeof(T));
+            throw;
+        }
+        releaseBlock();
+        data_ = block;
+        capacity_ = capacity;
+    }
+
+    void growFor(std::size_t count) {
+        if (count > capacity_) {
+            growTo(std::max(count, capacity_ * 2));
+        }
+    }
+
+    // Takes other's elements: its block if it has one, else element by element
+    void steal(SmallVector& other) {
+        if (other.is_inline()) {
+            relocate(other.data_, other.size_, inlineData());
+            data_ = inlineData();
+            capacity_ = N;
+        } else {
+            data_ = std::exchange(other.data_, other.inlineData());
+            capacity_ = std::exchange(other.capacity_, N);
+        }
+        pool = other.pool;
+        size_ = std::exchange(other.size_, 0);
+    }
+
+public:
+    explicit SmallVector(Pool& pool) : data_(inlineData()), pool(&pool) {}
+
+    SmallVector(Pool& pool, std::initializer_list<T> items) : SmallVector(pool) {
+        reserve(items.size());
+        for (const T& item : items) {
+            ::new (static_cast<void*>(data_ + size_)) T(item);
+            ++size_;
+        }
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector(*other.pool) {
+        reserve(other.size_);
+        for (const T& item : other) {
+            ::new (static_cast<void*>(data_ + size_)) T(item);
+            ++size_;
+        }
+    }
+
+    SmallVector(SmallVector&& other) noexcept(trivially_relocatable<T>::value ||
+                                             std::is_nothrow_move_constructible<T>::value)
+        : data_(inlineData()), pool(other.pool) {
+        steal(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            for (const T& item : other) {
+                ::new (static_cast<void*>(data_ + size_)) T(item);
+                ++size_;
+            }
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(trivially_relocatable<T>::value ||
+                                                        std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            clear();
+            releaseBlock();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        clear();
+        releaseBlock();
+    }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t capacity() const { return capacity_; }
+
+    static constexpr std::size_t inline_capacity() { return N; }
+
+    // Whether the elements still live inside the object
+    bool is_inline() const {
+        return data_ == reinterpret_cast<const T*>(inline_);
+    }
+
+    Pool& get_pool() const {
+        return *pool;
+    }
+
+    T& operator[](std::size_t index) { return data_[index]; }
+    const T& operator[](std::size_t index) const { return data_[index]; }
+
+    T& at(std::size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return data_[index];
+    }
+
+    const T& at(std::size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return data_[index];
+    }
+
+    T& front() { return data_[0]; }
+    const T& front() const { return data_[0]; }
+    T& back() { return data_[size_ - 1]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    void reserve(std::size_t count) {
+        if (count > capacity_) {
+            growTo(count);
+        }
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            // Built before growing, since args may refer to an element
+            T item(std::forward<Args>(args)...);
+            growFor(size_ + 1);
+            ::new (static_cast<void*>(data_ + size_)) T(std::move(item));
+        } else {
+            ::new (static_cast<void*>(data_ + size_)) T(std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    void push_back(const T& item) {
+        emplace_back(item);
+    }
+
+    void push_back(T&& item) {
+        emplace_back(std::move(item));
+    }
+
+    void pop_back() {
+        data_[--size_].~T();
+    }
+
+    iterator insert(const_iterator position, T item) {
+        std::size_t index = static_cast<std::size_t>(position - data_);
+        emplace_back(std::move(item));
+        std::rotate(data_ + index, data_ + size_ - 1, data_ + size_);
+        return data_ + index;
+    }
+
+    iterator erase(const_iterator position) {
+        std::size_t index = static_cast<std::size_t>(position - data_);
+        std::move(data_ + index + 1, data_ + size_, data_ + index);
+        pop_back();
+        return data_ + index;
+    }
+
+    void resize(std::size_t count) {
+        resize(count, T());
+    }
+
+    void resize(std::size_t count, const T& value) {
+        while (size_ > count) {
+            pop_back();
+        }
+        if (count > size_) {
+            growFor(count);
+            for (; size_ < count; ++size_) {
+                ::new (static_cast<void*>(data_ + size_)) T(value);
+            }
+        }
+    }
+
+    // Destroys the elements but keeps the capacity
+    void clear() {
+        for (std::size_t i = 0; i < size_; ++i) {
+            data_[i].~T();
+        }
+        size_ = 0;
+    }
+
+    friend bool operator==(const SmallVector& a, const SmallVector& b) {
+        return a.size_ == b.size_ && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(const SmallVector& a, const SmallVector& b) {
+        return !(a == b);
+    }
+};
+
+template <typename T, std::size_t N, typename Pool = SizeClassedPool>
+using small_vector = SmallVector<T, N, Pool>;
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ThreadRegistry.hpp"
+
+namespace thread_heap_detail {
+
+// Start of every heap; the blocks follow. Heaps are aligned to their own
+// size, so a block finds its heap by masking its address.
+struct Heap {
+    // Written by foreign threads, on a line of its own
+    alignas(64) std::atomic<void*> remoteFrees{nullptr};
+    std::atomic<std::size_t> remoteFreeCount{0};
+
+    // Owner only
+    alignas(64) std::atomic<std::thread::id> owner;
+    void* localFree = nullptr;
+    std::size_t bumpIndex = 0; // Blocks past this one were never handed out
+    Heap* nextAbandoned = nullptr; // Guarded by the pool's mutex
+};
+
+constexpr std::size_t headerBytes = (sizeof(Heap) + 63) / 64 * 64;
+
+inline void*& link(void* block) {
+    return *static_cast<void**>(block);
+}
+
+} // namespace thread_heap_detail
+
+// Thread-safe fixed-size block pool in which every thread allocates from a
+// heap of its own, after mimalloc's delayed frees. Freeing a block of the
+// calling thread's heap is a plain push onto a local free list. Freeing a
+// block that another thread's heap owns is one atomic push onto that heap's
+// remote-free list. When its local list runs dry, the owner takes the whole
+// remote list with a single exchange and allocates from it, so a
+// producer/consumer pipeline shares no hot free list and takes no lock. Each
+// heap holds blocksPerThread blocks; allocate() throws std::bad_alloc when
+// the calling thread's heap is exhausted. A thread's heap outlives the
+// thread: it is abandoned on exit, still collects remote frees, and is
+// adopted by the next thread that needs a heap.
+class ThreadHeapPool {
+private:
+    using Heap = thread_heap_detail::Heap;
+    using Registry = ThreadRegistry<ThreadHeapPool, Heap*>;
+    friend Registry;
+
+    std::size_t blockSize;
+    std::size_t blocksPerThread;
+    std::size_t stride;
+    std::size_t heapBytes; // Power of two, also the heap's alignment
+    std::uint64_t id;
+    std::mutex mutex;
+    std::vector<Heap*> heaps;       // Guarded by mutex
+    Heap* abandoned = nullptr;      // Guarded by mutex
+
+    static std::size_t strideFor(std::size_t blockSize, std::size_t blocksPerThread) {
+        if (blockSize == 0 || blocksPerThread == 0) {
+            throw std::invalid_argument("ThreadHeapPool: blockSize and blocksPerThread must be positive");
+        }
+        std::size_t size = blockSize < sizeof(void*) ? sizeof(void*) : blockSize;
+        return (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    }
+
+    static std::size_t heapBytesFor(std::size_t stride, std::size_t blocksPerThread) {
+        std::size_t needed = thread_heap_detail::headerBytes + stride * blocksPerThread;
+        std::size_t bytes = 4096;
+        while (bytes < needed) {
+            bytes *= 2;
+        }
+        return bytes;
+    }
+
+    Heap* heapOf(const void* block) const {
+        return reinterpret_cast<Heap*>(reinterpret_cast<std::uintptr_t>(block) & ~(heapBytes - 1));
+    }
+
+    Heap* acquireHeap() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Heap* heap = abandoned;
+        if (heap != nullptr) {
+            abandoned = heap->nextAbandoned;
+        } else {
+            void* memory = std::aligned_alloc(heapBytes, heapBytes);
+            if (memory == nullptr) {
+                throw std::bad_alloc();
+            }
+            heap = new (memory) Heap();
+            heaps.push_back(heap);
+        }
+        heap->owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        return heap;
+    }
+
+    // Thread exit: the heap waits for the next thread that needs one
+    void detachThread(Heap* heap) {
+        std::lock_guard<std::mutex> lock(mutex);
+        heap->owner.store(std::thread::id(), std::memory_order_relaxed);
+        heap->nextAbandoned = abandoned;
+        abandoned = heap;
+    }
+
+    Heap* localHeap() {
+        if (Heap** heap = Registry::find(id)) {
+            return *heap;
+        }
+        return Registry::attach(id, this, acquireHeap());
+    }
+
+public:
+    ThreadHeapPool(std::size_t blockSize, std::size_t blocksPerThread)
+        : blockSize(blockSize),
+          blocksPerThread(blocksPerThread),
+          stride(strideFor(blockSize, blocksPerThread)),
+          heapBytes(heapBytesFor(stride, blocksPerThread)),
+          id(Registry::registerOwner()) {
+    }
+
+    // Every block goes away with its heap
+    ~ThreadHeapPool() {
+        Registry::unregisterOwner(id);
+        Registry::forget(id);
+        for (Heap* heap : heaps) {
+            heap->~Heap();
+            std::free(heap);
+        }
+    }
+
+    ThreadHeapPool(const ThreadHeapPool&) = delete;
+    ThreadHeapPool& operator=(const ThreadHeapPool&) = delete;
+
+    void* allocate() {
+        Heap* heap = localHeap();
+        if (heap->localFree == nullptr) {
+            // Take every remote free in one batch
+            heap->localFree = heap->remoteFrees.exchange(nullptr, std::memory_order_acquire);
+        }
+        if (void* block = heap->localFree) {
+            heap->localFree = thread_heap_detail::link(block);
+            return block;
+        }
+        if (heap->bumpIndex < blocksPerThread) {
+            return reinterpret_cast<unsigned char*>(heap) + thread_heap_detail::headerBytes +
+                   heap->bumpIndex++ * stride;
+        }
+        throw std::bad_alloc();
+    }
+
+    void deallocate(void* block) {
+        Heap* heap = heapOf(block);
+        if (heap->owner.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+            thread_heap_detail::link(block) = heap->localFree;
+            heap->localFree = block;
+            return;
+        }
+        void* head = heap->remoteFrees.load(std::memory_order_relaxed);
+        do {
+            thread_heap_detail::link(block) = head;
+        } while (!heap->remoteFrees.compare_exchange_weak(head, block, std::memory_order_release,
+                                                          std::memory_order_relaxed));
+        heap->remoteFreeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::size_t getBlockSize() const {
+        return blockSize;
+    }
+
+    std::size_t getBlocksPerThread() const {
+        return blocksPerThread;
+    }
+
+    // Heaps created so far; abandoned heaps are reused before a new one is made
+    std::size_t getHeapCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return heaps.size();
+    }
+
+    // Frees that went through a remote-free list, over all heaps
+    std::size_t getRemoteFreeCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::size_t count = 0;
+        for (Heap* heap : heaps) {
+            count += heap->remoteFreeCount.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+};
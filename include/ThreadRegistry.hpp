@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Per-thread state that an object shared between threads (the owner) keeps
+// for every thread that uses it: a block cache, a batch, a reclamation
+// record. Each thread holds its states in one thread_local list per
+// registry. When a thread exits, every state whose owner is still alive is
+// handed back through Owner::detachThread(State&). This runs under the
+// registry lock, so an owner that is being destroyed waits in
+// unregisterOwner() until exiting threads are done with it. States of owners
+// destroyed in the meantime are dropped the next time the thread attaches.
+// Every Owner/State pair gets its own lock and live set, so one component's
+// exit handler may safely use another component.
+template <typename Owner, typename State>
+class ThreadRegistry {
+private:
+    struct Entry {
+        std::uint64_t ownerId;
+        Owner* owner;
+        State state;
+    };
+
+    struct Entries {
+        std::vector<Entry> entries;
+
+        ~Entries() {
+            std::lock_guard<std::mutex> lock(mutex());
+            for (Entry& entry : entries) {
+                if (liveOwners().count(entry.ownerId) != 0) {
+                    entry.owner->detachThread(entry.state);
+                }
+            }
+        }
+    };
+
+    static std::mutex& mutex() {
+        static std::mutex instance;
+        return instance;
+    }
+
+    static std::unordered_set<std::uint64_t>& liveOwners() {
+        static std::unordered_set<std::uint64_t> ids;
+        return ids;
+    }
+
+    static std::vector<Entry>& local() {
+        thread_local Entries instance;
+        return instance.entries;
+    }
+
+public:
+    // Id for a new owner; never reused
+    static std::uint64_t registerOwner() {
+        static std::atomic<std::uint64_t> counter{0};
+        std::uint64_t id = counter.fetch_add(1, std::memory_order_relaxed) + 1;
+        std::lock_guard<std::mutex> lock(mutex());
+        liveOwners().insert(id);
+        return id;
+    }
+
+    // Waits for exiting threads that are detaching from the owner; no thread
+    // detaches from it afterwards
+    static void unregisterOwner(std::uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex());
+        liveOwners().erase(id);
+    }
+
+    // Drops the calling thread's state for the owner without detaching
+    static void forget(std::uint64_t id) {
+        std::vector<Entry>& entries = local();
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [id](const Entry& entry) { return entry.ownerId == id; }),
+                      entries.end());
+    }
+
+    // The calling thread's state for the owner, or null before attach()
+    static State* find(std::uint64_t id) {
+        for (Entry& entry : local()) {
+            if (entry.ownerId == id) {
+                return &entry.state;
+            }
+        }
+        return nullptr;
+    }
+
+    // Adds the calling thread's state for the owner. Valid until the thread
+    // attaches to another owner of this registry.
+    static State& attach(std::uint64_t id, Owner* owner, State state) {
+        std::vector<Entry>& entries = local();
+        {
+            // First use on this thread: forget owners gone since
+            std::lock_guard<std::mutex> lock(mutex());
+            entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                         [](const Entry& entry) { return liveOwners().count(entry.ownerId) == 0; }),
+                          entries.end());
+        }
+        entries.push_back(Entry{id, owner, std::move(state)});
+        return entries.back().state;
+    }
+};
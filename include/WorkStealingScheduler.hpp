@@ -0,0 +1,420 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new> // For std::bad_alloc
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "PoolManager.hpp"
+
+// Chase-Lev work-stealing deque of pointers with a fixed capacity (the C11
+// formulation of Lê et al.). The owner pushes and takes at the bottom
+// without contention; thieves take from the top with one CAS.
+template <typename T>
+class ChaseLevDeque {
+    static_assert(std::is_pointer<T>::value, "ChaseLevDeque: holds pointers");
+
+private:
+    std::unique_ptr<std::atomic<T>[]> slots;
+    std::int64_t mask;
+    alignas(64) std::atomic<std::int64_t> top{0};
+    alignas(64) std::atomic<std::int64_t> bottom{0};
+
+public:
+    explicit ChaseLevDeque(std::size_t capacity)
+        : slots(new std::atomic<T>[capacity]), mask(static_cast<std::int64_t>(capacity) - 1) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("ChaseLevDeque: capacity must be a power of two of at least 2");
+        }
+    }
+
+    // Owner only; false when full
+    bool push(T item) {
+        std::int64_t b = bottom.load(std::memory_order_relaxed);
+        std::int64_t t = top.load(std::memory_order_acquire);
+        if (b - t > mask) {
+            return false;
+        }
+        slots[b & mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner only; newest item first, nullptr when empty
+    T take() {
+        std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        T item = nullptr;
+        if (t <= b) {
+            item = slots[b & mask].load(std::memory_order_relaxed);
+            if (t == b) {
+                // Last item: race the thieves for it
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = nullptr;
+                }
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread; oldest item first, nullptr when empty or on a lost race
+    T steal() {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        T item = slots[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    std::size_t getCapacity() const {
+        return static_cast<std::size_t>(mask + 1);
+    }
+};
+
+namespace work_stealing_detail {
+
+// Header at the start of each task block; the closure follows it
+struct Task {
+    void (*invoke)(Task* task); // Runs and destroys the closure
+    Task* next;                 // Injection queue or remote-free list
+    unsigned owner;             // Worker whose pool holds the block
+};
+
+constexpr std::size_t closureOffset =
+    (sizeof(Task) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+template <typename F>
+void invokeClosure(Task* task) {
+    F* closure = std::launder(reinterpret_cast<F*>(reinterpret_cast<unsigned char*>(task) + closureOffset));
+    (*closure)();
+    closure->~F();
+}
+
+} // namespace work_stealing_detail
+
+// Fork-join scheduler with one Chase-Lev deque and one PoolManager per
+// worker. A task spawned on a worker is built in a block of that worker's
+// pool and pushed onto its deque; idle workers steal from the other end.
+// Whoever runs a stolen task does not free it into its own pool: the block
+// goes onto a lock-free list of its owner, which takes the whole list back
+// with one exchange between tasks, so every pool stays single-threaded and
+// spawning never calls malloc. Tasks from outside the workers go through an
+// injection queue whose pool is guarded by a mutex. When the spawning
+// worker's deque is full or its pool is dry, the task runs inline. Closures
+// must fit in taskBytes minus a small header and must not throw.
+class WorkStealingScheduler {
+private:
+    using Task = work_stealing_detail::Task;
+
+    struct alignas(64) Worker {
+        PoolManager tasks;
+        ChaseLevDeque<Task*> deque;
+        std::atomic<Task*> remoteFrees{nullptr}; // Blocks freed by other workers
+        std::thread thread;
+
+        Worker(std::size_t taskBytes, std::size_t tasksPerWorker, std::size_t dequeCapacity)
+            : tasks(taskBytes, tasksPerWorker), deque(dequeCapacity) {}
+    };
+
+    struct Current {
+        WorkStealingScheduler* scheduler = nullptr;
+        unsigned index = 0;
+    };
+
+    std::size_t taskBytes;
+    std::vector<std::unique_ptr<Worker>> workers;
+    unsigned external; // Owner index of tasks spawned from outside
+
+    std::mutex injectionMutex;
+    PoolManager injectionTasks; // Guarded by injectionMutex
+    Task* injectionHead = nullptr;
+    Task* injectionTail = nullptr;
+
+    std::atomic<std::size_t> queued{0};  // Tasks in deques or the injection queue
+    std::atomic<std::size_t> pending{0}; // Spawned but not finished
+    std::atomic<unsigned> sleepers{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    bool stopping = false; // Guarded by sleepMutex
+
+    std::atomic<std::size_t> stealCount{0};
+    std::atomic<std::size_t> remoteFreeCount{0};
+    std::atomic<std::size_t> inlineCount{0};
+
+    static Current& current() {
+        thread_local Current instance;
+        return instance;
+    }
+
+    void drainRemoteFrees(Worker& worker) {
+        Task* task = worker.remoteFrees.exchange(nullptr, std::memory_order_acquire);
+        while (task != nullptr) {
+            Task* next = task->next;
+            worker.tasks.deallocate(task);
+            task = next;
+        }
+    }
+
+    void freeTask(Task* task, unsigned runner) {
+        if (task->owner == runner) {
+            workers[runner]->tasks.deallocate(task);
+        } else if (task->owner == external) {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            injectionTasks.deallocate(task);
+        } else {
+            // Route the block home; the owner frees it into its own pool
+            std::atomic<Task*>& list = workers[task->owner]->remoteFrees;
+            task->next = list.load(std::memory_order_relaxed);
+            while (!list.compare_exchange_weak(task->next, task, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+            }
+            remoteFreeCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void finish() {
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            idle.notify_all();
+        }
+    }
+
+    void announce() {
+        queued.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wake.notify_one();
+        }
+    }
+
+    Task* popInjected() {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        Task* task = injectionHead;
+        if (task != nullptr) {
+            injectionHead = task->next;
+            if (injectionHead == nullptr) {
+                injectionTail = nullptr;
+            }
+        }
+        return task;
+    }
+
+    Task* findTask(unsigned index, std::uint64_t& seed) {
+        Task* task = workers[index]->deque.take();
+        if (task == nullptr) {
+            task = popInjected();
+        }
+        if (task == nullptr && workers.size() > 1) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            std::size_t start = static_cast<std::size_t>(seed >> 33) % workers.size();
+            for (std::size_t i = 0; i < workers.size() && task == nullptr; ++i) {
+                std::size_t victim = (start + i) % workers.size();
+                if (victim != index) {
+                    task = workers[victim]->deque.steal();
+                    if (task != nullptr) {
+                        stealCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+        if (task != nullptr) {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    void run(unsigned index) {
+        current() = Current{this, index};
+        Worker& worker = *workers[index];
+        std::uint64_t seed = index + 1;
+        while (true) {
+            if (Task* task = findTask(index, seed)) {
+                task->invoke(task);
+                freeTask(task, index);
+                finish();
+                if (worker.remoteFrees.load(std::memory_order_relaxed) != nullptr) {
+                    drainRemoteFrees(worker);
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_seq_cst) > 0; });
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+            if (stopping && pending.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    template <typename F>
+    static void checkFits(std::size_t taskBytes) {
+        static_assert(alignof(F) <= alignof(std::max_align_t), "WorkStealingScheduler: over-aligned closure");
+        if (work_stealing_detail::closureOffset + sizeof(F) > taskBytes) {
+            throw std::bad_alloc();
+        }
+    }
+
+    // Constructs the task in a block of tasks; the block goes back if the closure's constructor throws
+    template <typename F>
+    static Task* build(PoolManager& tasks, F&& closure, unsigned owner) {
+        using Closure = std::decay_t<F>;
+        void* block = tasks.allocate();
+        try {
+            ::new (static_cast<unsigned char*>(block) + work_stealing_detail::closureOffset)
+                Closure(std::forward<F>(closure));
+        } catch (...) {
+            tasks.deallocate(block);
+            throw;
+        }
+        auto* task = static_cast<Task*>(block);
+        task->invoke = &work_stealing_detail::invokeClosure<Closure>;
+        task->next = nullptr;
+        task->owner = owner;
+        return task;
+    }
+
+public:
+    // taskBytes is the block size of every worker's pool; tasksPerWorker
+    // blocks each, plus as many for tasks spawned from outside
+    explicit WorkStealingScheduler(unsigned workerCount, std::size_t taskBytes = 128,
+                                   std::size_t tasksPerWorker = 1024, std::size_t dequeCapacity = 1024)
+        : taskBytes(taskBytes),
+          external(workerCount),
+          injectionTasks(taskBytes, tasksPerWorker) {
+        if (workerCount == 0 || taskBytes <= work_stealing_detail::closureOffset) {
+            throw std::invalid_argument("WorkStealingScheduler: need at least one worker and room for a closure");
+        }
+        for (unsigned i = 0; i < workerCount; ++i) {
+            workers.push_back(std::make_unique<Worker>(taskBytes, tasksPerWorker, dequeCapacity));
+        }
+        for (unsigned i = 0; i < workerCount; ++i) {
+            workers[i]->thread = std::thread([this, i] { run(i); });
+        }
+    }
+
+    // Waits for every spawned task, then joins the workers
+    ~WorkStealingScheduler() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::unique_ptr<Worker>& worker : workers) {
+            worker->thread.join();
+        }
+        // Blocks routed home after their owner's last drain
+        for (std::unique_ptr<Worker>& worker : workers) {
+            drainRemoteFrees(*worker);
+        }
+    }
+
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    // Queues closure(); on a worker of this scheduler it goes onto that
+    // worker's deque, anywhere else onto the injection queue
+    template <typename F>
+    void spawn(F&& closure) {
+        checkFits<std::decay_t<F>>(taskBytes);
+        Current& self = current();
+        if (self.scheduler == this) {
+            Worker& worker = *workers[self.index];
+            if (worker.tasks.pool.getAvailableCount() == 0) {
+                drainRemoteFrees(worker);
+            }
+            if (worker.tasks.pool.getAvailableCount() == 0) {
+                inlineCount.fetch_add(1, std::memory_order_relaxed);
+                closure();
+                return;
+            }
+            Task* task = build(worker.tasks, std::forward<F>(closure), self.index);
+            pending.fetch_add(1, std::memory_order_relaxed);
+            if (!worker.deque.push(task)) {
+                // Deque full: run it here rather than grow
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                inlineCount.fetch_add(1, std::memory_order_relaxed);
+                task->invoke(task);
+                worker.tasks.deallocate(task);
+                return;
+            }
+            announce();
+            return;
+        }
+        pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            Task* task;
+            try {
+                task = build(injectionTasks, std::forward<F>(closure), external);
+            } catch (...) {
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                throw;
+            }
+            if (injectionTail != nullptr) {
+                injectionTail->next = task;
+            } else {
+                injectionHead = task;
+            }
+            injectionTail = task;
+        }
+        announce();
+    }
+
+    // Blocks until every task spawned so far, and every task those spawn,
+    // has finished. Call from outside the workers.
+    void wait() {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        idle.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    unsigned getWorkerCount() const {
+        return static_cast<unsigned>(workers.size());
+    }
+
+    // Index of the calling worker, or getWorkerCount() outside the workers
+    unsigned currentWorker() const {
+        const Current& self = current();
+        return self.scheduler == this ? self.index : external;
+    }
+
+    std::size_t getTaskBytes() const {
+        return taskBytes;
+    }
+
+    std::size_t getStealCount() const {
+        return stealCount.load(std::memory_order_relaxed);
+    }
+
+    // Stolen tasks whose blocks went back to their owner's remote-free list
+    std::size_t getRemoteFreeCount() const {
+        return remoteFreeCount.load(std::memory_order_relaxed);
+    }
+
+    // Tasks run at spawn time because the deque was full or the pool dry
+    std::size_t getInlineCount() const {
+        return inlineCount.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new/delete so a test can check that a code
+// path makes no heap allocations. Include it from the one test file of an
+// executable that needs it; replacements must be defined exactly once.
+inline std::size_t heapAllocations = 0;
+
+void* operator new(std::size_t bytes) {
+    ++heapAllocations;
+    if (void* memory = std::malloc(bytes == 0 ? 1 : bytes)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
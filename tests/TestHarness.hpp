@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Minimal self-registering test harness; each test file is its own executable
+struct TestCase {
+    const char* name;
+    std::function<void()> body;
+};
+
+inline std::vector<TestCase>& testRegistry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+struct TestFailure : std::exception {
+    std::string message;
+
+    explicit TestFailure(std::string message) : message(std::move(message)) {}
+
+    const char* what() const noexcept override {
+        return message.c_str();
+    }
+};
+
+struct TestRegistrar {
+    TestRegistrar(const char* name, std::function<void()> body) {
+        testRegistry().push_back({name, std::move(body)});
+    }
+};
+
+#define TEST_CONCAT_INNER(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_INNER(a, b)
+
+#define TEST(name)                                                            \
+    static void name();                                                       \
+    static TestRegistrar TEST_CONCAT(name, _registrar)(#name, &name);         \
+    static void name()
+
+#define CHECK(expr)                                                           \
+    do {                                                                      \
+        if (!(expr)) {                                                        \
+            throw TestFailure(std::string(__FILE__) + ":" +                   \
+                              std::to_string(__LINE__) + ": CHECK(" #expr ")"); \
+        }                                                                     \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
+
+#define CHECK_THROWS(expr, exceptionType)                                     \
+    do {                                                                      \
+        bool thrown = false;                                                  \
+        try {                                                                 \
+            (void)(expr);                                                     \
+        } catch (const exceptionType&) {                                      \
+            thrown = true;                                                    \
+        }                                                                     \
+        if (!thrown) {                                                        \
+            throw TestFailure(std::string(__FILE__) + ":" +                   \
+                              std::to_string(__LINE__) +                      \
+                              ": expected " #exceptionType " from " #expr);   \
+        }                                                                     \
+    } while (0)
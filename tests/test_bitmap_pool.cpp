@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "BitmapPool.hpp"
+#include "TestHarness.hpp"
+
+TEST(handsOutBlocksInAddressOrder) {
+    BitmapPool pool(40, 200);
+    std::vector<unsigned char*> blocks;
+    for (int i = 0; i < 200; ++i) {
+        blocks.push_back(static_cast<unsigned char*>(pool.allocate()));
+    }
+    for (std::size_t i = 1; i < blocks.size(); ++i) {
+        CHECK_EQ(static_cast<std::size_t>(blocks[i] - blocks[i - 1]), 48u);
+    }
+    CHECK(!pool.hasAvailableMemory());
+    CHECK_THROWS(pool.allocate(), std::bad_alloc);
+    for (unsigned char* block : blocks) {
+        pool.deallocate(block);
+    }
+    CHECK_EQ(pool.getAvailableCount(), 200u);
+}
+
+TEST(reusesLowestFreeBlock) {
+    BitmapPool pool(16, 5000);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 5000; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    // Free in a scrambled order; allocation must still come back lowest first
+    std::vector<std::size_t> order(blocks.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    for (std::size_t i = 0; i < 1000; ++i) {
+        pool.deallocate(blocks[order[i]]);
+    }
+    std::vector<std::size_t> freed(order.begin(), order.begin() + 1000);
+    std::sort(freed.begin(), freed.end());
+    for (std::size_t index : freed) {
+        CHECK_EQ(pool.blockIndex(pool.allocate()), index);
+    }
+    CHECK_EQ(pool.getAvailableCount(), 0u);
+}
+
+TEST(searchFindsHolesAcrossSummaryWords) {
+    BitmapPool pool(8, 64 * 64 * 3 + 5);
+    std::vector<void*> blocks;
+    for (std::size_t i = 0; i < pool.getCapacity(); ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    pool.deallocate(blocks.back());
+    pool.deallocate(blocks[64 * 64 * 2 + 1]);
+    CHECK(pool.isFree(64 * 64 * 2 + 1));
+    CHECK_EQ(pool.blockIndex(pool.allocate()), 64u * 64 * 2 + 1);
+    CHECK_EQ(pool.blockIndex(pool.allocate()), pool.getCapacity() - 1);
+    pool.deallocate(blocks[3]);
+    CHECK_EQ(pool.blockIndex(pool.allocate()), 3u);
+}
+
+TEST(trimReleasesTheFreeTail) {
+    std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    BitmapPool pool(page, 8);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        blocks.push_back(pool.allocate());
+        std::memset(blocks.back(), 0xAB, page);
+    }
+    for (int i = 2; i < 8; ++i) {
+        pool.deallocate(blocks[i]);
+    }
+    CHECK_EQ(pool.trim(), 6 * page);
+    CHECK_EQ(static_cast<unsigned char*>(blocks[1])[0], 0xABu); // Live blocks untouched
+    auto* reused = static_cast<unsigned char*>(pool.allocate());
+    CHECK(reused == blocks[2]);
+    CHECK_EQ(reused[0], 0u);
+    pool.deallocate(blocks[0]);
+    pool.deallocate(blocks[1]);
+    pool.deallocate(reused);
+    CHECK_EQ(pool.trim(), 8 * page);
+}
+
+TEST(ownsOnlyItsSlab) {
+    BitmapPool pool(32, 4);
+    void* block = pool.allocate();
+    int outside = 0;
+    CHECK(pool.owns(block));
+    CHECK(!pool.owns(&outside));
+    pool.deallocate(block);
+}
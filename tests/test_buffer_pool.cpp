@@ -0,0 +1,94 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "BufferPool.hpp"
+#include "TestHarness.hpp"
+
+TEST(buffersArePageAlignedAndRecycled) {
+    BufferPool pool(1000, 2);
+    std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    CHECK_EQ(pool.getBufferSize(), page);
+    {
+        Buffer buffer = pool.acquire();
+        CHECK_EQ(reinterpret_cast<std::uintptr_t>(buffer.data()) % page, 0u);
+        CHECK_EQ(pool.getAvailableCount(), 1u);
+    }
+    CHECK_EQ(pool.getAvailableCount(), 2u);
+}
+
+TEST(slicesKeepTheBlockAlive) {
+    BufferPool pool(4096, 1);
+    BufferSlice word;
+    {
+        Buffer buffer = pool.acquire();
+        std::memcpy(buffer.data(), "hello world", 11);
+        buffer.setSize(11);
+        word = buffer.slice(6, 5);
+        CHECK_EQ(buffer.useCount(), 2u);
+        CHECK_THROWS(buffer.slice(6, 6), std::out_of_range);
+    }
+    CHECK_EQ(pool.getAvailableCount(), 0u);
+    CHECK_EQ(word.view(), "world");
+    BufferSlice inner = word.slice(1, 3);
+    CHECK_EQ(inner.view(), "orl");
+    word = BufferSlice();
+    inner = BufferSlice();
+    CHECK_EQ(pool.getAvailableCount(), 1u);
+    CHECK_THROWS(word.slice(0, 1), std::out_of_range);
+}
+
+TEST(acquireFailsWhenExhausted) {
+    BufferPool pool(4096, 1);
+    Buffer held = pool.acquire();
+    CHECK_THROWS(pool.acquire(), std::bad_alloc);
+}
+
+// Length-prefixed records sent with writev and parsed in place after readv
+TEST(scatterGatherOverSocketpair) {
+    int fds[2];
+    CHECK_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    BufferPool pool(4096, 4);
+
+    Buffer outgoing = pool.acquire();
+    const char* records[] = {"alpha", "beta", "gamma"};
+    std::vector<BufferSlice> frames;
+    std::size_t offset = 0;
+    for (const char* record : records) {
+        std::uint8_t length = static_cast<std::uint8_t>(std::strlen(record));
+        outgoing.data()[offset] = length;
+        std::memcpy(outgoing.data() + offset + 1, record, length);
+        outgoing.setSize(offset + 1 + length);
+        frames.push_back(outgoing.slice(offset, 1 + length));
+        offset += 1 + length;
+    }
+    CHECK_EQ(writeFrom(fds[0], frames.data(), frames.size()), static_cast<ssize_t>(offset));
+
+    Buffer incoming[2] = {pool.acquire(), pool.acquire()};
+    std::size_t received = 0;
+    while (received < offset) {
+        ssize_t n = readInto(fds[1], incoming, 2);
+        CHECK(n > 0);
+        received += static_cast<std::size_t>(n);
+    }
+
+    BufferSlice stream = incoming[0].filledSlice();
+    std::vector<BufferSlice> parsed;
+    for (std::size_t at = 0; at < stream.size();) {
+        std::size_t length = stream.data()[at];
+        parsed.push_back(stream.slice(at + 1, length));
+        at += 1 + length;
+    }
+    CHECK_EQ(parsed.size(), 3u);
+    CHECK_EQ(parsed[0].view(), "alpha");
+    CHECK_EQ(parsed[2].view(), "gamma");
+    CHECK(parsed[1].data() >= incoming[0].data()); // Points into the read buffer: no copy
+    CHECK_EQ(incoming[0].useCount(), 5u);
+
+    close(fds[0]);
+    close(fds[1]);
+}
@@ -0,0 +1,125 @@
+#include <coroutine>
+#include <exception>
+#include <thread>
+
+#include "CoroutineFramePool.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+std::size_t lastFrameSize = 0;
+
+// Eager coroutine that records its frame address and suspends at the end
+struct Probe {
+    struct promise_type : PoolAllocatedFrame {
+        // Records the frame size the compiler asks for
+        static void* operator new(std::size_t size) {
+            lastFrameSize = size;
+            return PoolAllocatedFrame::operator new(size);
+        }
+
+        Probe get_return_object() {
+            return Probe{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    void* frame() const {
+        return handle.address();
+    }
+
+    void destroy() {
+        handle.destroy();
+    }
+};
+
+Probe probe(int value) {
+    volatile int local = value;
+    (void)local;
+    co_return;
+}
+
+} // namespace
+
+TEST(framesAreRecycledPerSize) {
+    Probe first = probe(1);
+    void* address = first.frame();
+    first.destroy();
+
+    Probe second = probe(2);
+    CHECK_EQ(second.frame(), address); // Same class, most recently freed frame
+    second.destroy();
+}
+
+TEST(concurrentFramesGetDistinctBlocks) {
+    Probe a = probe(1);
+    Probe b = probe(2);
+    CHECK(a.frame() != b.frame());
+    a.destroy();
+    b.destroy();
+}
+
+TEST(framesFreedOnAnotherThreadJoinThatThreadsPool) {
+    Probe created = probe(3);
+    std::size_t frameSize = lastFrameSize;
+    CHECK(frameSize > 0 && frameSize <= CoroutineFramePool::maxPooledFrame);
+    std::size_t idleBefore = 0;
+    std::size_t idleAfter = 0;
+    std::thread([&] {
+        Probe own = probe(4); // Leaves room in this thread's class
+        idleBefore = CoroutineFramePool::idleFrames(frameSize);
+        created.destroy();
+        idleAfter = CoroutineFramePool::idleFrames(frameSize);
+        own.destroy();
+    }).join();
+    CHECK_EQ(idleAfter, idleBefore + 1);
+}
+
+TEST(dryClassesGrowByWholeChunks) {
+    std::size_t frameSize = 0;
+    std::size_t idleAfterGrowth = 0;
+    std::size_t idleAtEnd = 0;
+    std::thread([&] {
+        Probe frames[CoroutineFramePool::initialBlocksPerClass + 1];
+        for (Probe& frame : frames) {
+            frame = probe(5);
+        }
+        frameSize = lastFrameSize;
+        // The last frame doubled the class rather than coming from malloc
+        idleAfterGrowth = CoroutineFramePool::idleFrames(frameSize);
+        for (Probe& frame : frames) {
+            frame.destroy();
+        }
+        idleAtEnd = CoroutineFramePool::idleFrames(frameSize);
+    }).join();
+    CHECK_EQ(idleAfterGrowth, CoroutineFramePool::initialBlocksPerClass - 1);
+    CHECK_EQ(idleAtEnd, 2 * CoroutineFramePool::initialBlocksPerClass);
+}
+
+TEST(fullClassesFreeForeignFrames) {
+    constexpr std::size_t count = CoroutineFramePool::initialBlocksPerClass + 8;
+    Probe frames[count];
+    for (Probe& frame : frames) {
+        frame = probe(6);
+    }
+    std::size_t frameSize = lastFrameSize;
+    std::size_t idle = 0;
+    std::thread([&] {
+        for (Probe& frame : frames) {
+            frame.destroy();
+        }
+        idle = CoroutineFramePool::idleFrames(frameSize);
+    }).join();
+    CHECK_EQ(idle, CoroutineFramePool::initialBlocksPerClass); // A fresh class has no room to spare
+}
+
+TEST(oversizedFramesBypassThePools) {
+    void* frame = CoroutineFramePool::allocate(CoroutineFramePool::maxPooledFrame + 1);
+    CHECK(frame != nullptr);
+    CoroutineFramePool::deallocate(frame, CoroutineFramePool::maxPooledFrame + 1);
+}
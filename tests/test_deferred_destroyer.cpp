@@ -0,0 +1,106 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "DeferredDestroyer.hpp"
+#include "MemoryPool.hpp"
+#include "PoolManager.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+std::atomic<int> liveNodes{0};
+
+struct Node {
+    int value;
+    std::vector<std::unique_ptr<Node, std::function<void(Node*)>>> children;
+
+    explicit Node(int value) : value(value) { ++liveNodes; }
+    ~Node() { --liveNodes; }
+};
+
+} // namespace
+
+TEST(deleterOnlyQueues) {
+    MemoryPool pool(sizeof(Node), 4);
+    DeferredDestroyer destroyer(16);
+    {
+        auto node = make_unique_deferred<Node>(pool, destroyer, 1);
+        CHECK_EQ(liveNodes.load(), 1);
+    }
+    CHECK_EQ(liveNodes.load(), 1); // Still alive: nothing ran on release
+    CHECK_EQ(pool.getAvailableCount(), 3u);
+    CHECK_EQ(destroyer.drain(), 1u);
+    CHECK_EQ(liveNodes.load(), 0);
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+}
+
+TEST(drainTearsDownWholeGraph) {
+    PoolManager manager(sizeof(Node), 64);
+    DeferredDestroyer destroyer(4);
+    {
+        auto root = manager.createDeferred<Node>(destroyer, 0);
+        for (int i = 1; i <= 5; ++i) {
+            auto child = manager.createDeferred<Node>(destroyer, i);
+            for (int j = 0; j < 3; ++j) {
+                child->children.push_back(manager.createDeferred<Node>(destroyer, i * 10 + j));
+            }
+            root->children.push_back(std::move(child));
+        }
+        CHECK_EQ(liveNodes.load(), 21);
+    }
+    CHECK_EQ(liveNodes.load(), 21);
+    CHECK_EQ(destroyer.drain(), 21u);
+    CHECK_EQ(liveNodes.load(), 0);
+    CHECK_EQ(manager.pool.getAvailableCount(), 64u);
+    CHECK_EQ(destroyer.getDestroyedCount(), 21u);
+}
+
+TEST(fullBatchesAreHandedOffAndDestructorDrains) {
+    MemoryPool pool(sizeof(Node), 32);
+    {
+        DeferredDestroyer destroyer(8);
+        for (int i = 0; i < 20; ++i) {
+            make_unique_deferred<Node>(pool, destroyer, i);
+        }
+        CHECK_EQ(liveNodes.load(), 20);
+    }
+    CHECK_EQ(liveNodes.load(), 0);
+    CHECK_EQ(pool.getAvailableCount(), 32u);
+}
+
+TEST(workerDrainsInBackground) {
+    FallbackChain chain;
+    chain.threadCacheBlocks = 16; // Safe to free into from the worker
+    PoolManager manager(sizeof(Node), 256, chain);
+    DeferredDestroyer destroyer(8);
+    destroyer.startWorker();
+    for (int i = 0; i < 64; ++i) {
+        manager.createDeferred<Node>(destroyer, i);
+    }
+    for (int spin = 0; spin < 2000 && destroyer.getDestroyedCount() < 64; ++spin) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK_EQ(destroyer.getDestroyedCount(), 64u);
+    CHECK_EQ(liveNodes.load(), 0);
+    destroyer.stopWorker();
+}
+
+TEST(exitingThreadHandsOverItsBatch) {
+    FallbackChain chain;
+    chain.threadCacheBlocks = 8;
+    PoolManager manager(sizeof(Node), 64, chain);
+    DeferredDestroyer destroyer(100);
+    std::thread producer([&] {
+        for (int i = 0; i < 10; ++i) {
+            manager.createDeferred<Node>(destroyer, i);
+        }
+    });
+    producer.join();
+    CHECK_EQ(liveNodes.load(), 10);
+    CHECK_EQ(destroyer.drain(), 10u);
+    CHECK_EQ(liveNodes.load(), 0);
+}
@@ -0,0 +1,226 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "EpochDomain.hpp"
+#include "MemoryPool.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+struct Node {
+    long value;
+    Node* next;
+};
+
+// Treiber stack whose popped nodes go through the epoch domain
+class Stack {
+private:
+    std::atomic<Node*> head{nullptr};
+    EpochDomain<>& domain;
+
+public:
+    explicit Stack(EpochDomain<>& domain) : domain(domain) {}
+
+    void push(long value) {
+        Node* node = new (domain.allocate()) Node{value, head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool pop(long& value) {
+        auto guard = domain.pin();
+        Node* node = head.load(std::memory_order_acquire);
+        while (node != nullptr &&
+               !head.compare_exchange_weak(node, node->next, std::memory_order_acquire, std::memory_order_acquire)) {
+        }
+        if (node == nullptr) {
+            return false;
+        }
+        value = node->value;
+        domain.retire(static_cast<void*>(node));
+        return true;
+    }
+};
+
+struct Counted {
+    static int live;
+    Counted() { ++live; }
+    ~Counted() { --live; }
+};
+
+int Counted::live = 0;
+
+// Retires another block from its destructor
+struct RetiresOnDestroy {
+    EpochDomain<>* domain;
+    ~RetiresOnDestroy() { domain->retire(domain->allocate()); }
+};
+
+// Readers check both halves; a block freed under a reader breaks the pair
+struct Checked {
+    std::atomic<long> value;
+    std::atomic<long> inverse;
+    explicit Checked(long value) : value(value), inverse(~value) {}
+    ~Checked() {
+        value.store(0, std::memory_order_relaxed);
+        inverse.store(0, std::memory_order_relaxed);
+    }
+};
+
+} // namespace
+
+TEST(pinnedReaderDelaysReclamation) {
+    MemoryPool pool(sizeof(Node), 4);
+    EpochDomain<> domain(pool);
+    void* block = domain.allocate();
+    {
+        auto guard = domain.pin();
+        domain.retire(block);
+        for (int i = 0; i < 5; ++i) {
+            domain.collect();
+        }
+        CHECK_EQ(pool.getAvailableCount(), 3u); // At most one epoch past the pin
+    }
+    for (int i = 0; i < 3 && pool.getAvailableCount() < 4; ++i) {
+        domain.collect();
+    }
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+    CHECK_EQ(domain.getReclaimedCount(), 1u);
+}
+
+TEST(readerOnAnotherThreadHoldsTheGracePeriod) {
+    MemoryPool pool(sizeof(Node), 4);
+    EpochDomain<> domain(pool);
+    std::atomic<int> phase{0};
+    std::thread reader([&] {
+        auto guard = domain.pin();
+        phase = 1;
+        while (phase.load() != 2) {
+            std::this_thread::yield();
+        }
+    });
+    while (phase.load() != 1) {
+        std::this_thread::yield();
+    }
+    domain.retire(domain.allocate());
+    for (int i = 0; i < 5; ++i) {
+        domain.collect();
+    }
+    CHECK_EQ(pool.getAvailableCount(), 3u);
+    phase = 2;
+    reader.join();
+    for (int i = 0; i < 3; ++i) {
+        domain.collect();
+    }
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+}
+
+TEST(retireRunsDestructor) {
+    MemoryPool pool(sizeof(Counted), 2);
+    {
+        EpochDomain<> domain(pool);
+        domain.retire(new (domain.allocate()) Counted());
+        CHECK_EQ(Counted::live, 1);
+    } // The domain reclaims what is left
+    CHECK_EQ(Counted::live, 0);
+    CHECK_EQ(pool.getAvailableCount(), 2u);
+}
+
+TEST(exitedThreadsLeaveOrphansForOthers) {
+    MemoryPool pool(sizeof(Node), 8);
+    EpochDomain<> domain(pool, 1000);
+    std::thread worker([&] {
+        for (int i = 0; i < 4; ++i) {
+            domain.retire(domain.allocate());
+        }
+    });
+    worker.join();
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+    for (int i = 0; i < 3; ++i) {
+        domain.collect();
+    }
+    CHECK_EQ(pool.getAvailableCount(), 8u);
+}
+
+TEST(orphanDestructorsMayRetireIntoTheDomain) {
+    MemoryPool pool(sizeof(RetiresOnDestroy), 4);
+    EpochDomain<> domain(pool, 1); // Every retire scans, including the destructor's
+    std::thread worker([&] { domain.retire(new (domain.allocate()) RetiresOnDestroy{&domain}); });
+    worker.join();
+    for (int i = 0; i < 6; ++i) {
+        domain.collect();
+    }
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+}
+
+TEST(readersNeverSeeAReclaimedNode) {
+    constexpr int readers = 3;
+    constexpr int writes = 20000;
+    MemoryPool pool(sizeof(Checked), writes); // Enough even if a reader is preempted while pinned
+    EpochDomain<> domain(pool, 8);
+    std::atomic<Checked*> current{new (domain.allocate()) Checked(1)};
+    std::atomic<bool> done{false};
+    std::atomic<long> torn{0};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                auto guard = domain.pin();
+                Checked* node = current.load(std::memory_order_acquire);
+                for (int i = 0; i < 8; ++i) {
+                    long value = node->value.load(std::memory_order_relaxed);
+                    if (node->inverse.load(std::memory_order_relaxed) != ~value) {
+                        torn.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    threads.emplace_back([&] {
+        for (long i = 2; i < writes; ++i) {
+            auto guard = domain.pin();
+            Checked* old = current.exchange(new (domain.allocate()) Checked(i), std::memory_order_acq_rel);
+            domain.retire(old);
+        }
+        done.store(true);
+    });
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    CHECK_EQ(torn.load(), 0L);
+    domain.retire(current.load());
+}
+
+TEST(concurrentStackReclaimsEveryNode) {
+    constexpr int threads = 4;
+    constexpr int perThread = 5000;
+    MemoryPool pool(sizeof(Node), threads * perThread);
+    EpochDomain<> domain(pool, 32);
+    Stack stack(domain);
+    std::atomic<long> popped{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < perThread; ++i) {
+                stack.push(t * perThread + i);
+                long value;
+                if (stack.pop(value)) {
+                    popped.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    long value;
+    while (stack.pop(value)) {
+        popped.fetch_add(1);
+    }
+    CHECK_EQ(popped.load(), static_cast<long>(threads * perThread));
+    for (int i = 0; i < 3; ++i) {
+        domain.collect();
+    }
+    CHECK_EQ(pool.getAvailableCount(), static_cast<std::size_t>(threads * perThread));
+}
@@ -0,0 +1,155 @@
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "FlatHashMap.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+// Pool large enough to hold every table size the tests grow through
+constexpr std::size_t kMaxTableBytes = 1 << 20;
+
+} // namespace
+
+TEST(insertFindErase) {
+    SizeClassedPool pools(64, kMaxTableBytes);
+    FlatHashMap<std::uint64_t, std::string> map(pools);
+    CHECK(map.find(1) == map.end());
+    CHECK(map.try_emplace(1, "one").second);
+    CHECK(!map.try_emplace(1, "uno").second);
+    CHECK_EQ(map.at(1), "one");
+    map[2] = "two";
+    CHECK_EQ(map.size(), 2u);
+    CHECK_EQ(map.erase(1), 1u);
+    CHECK_EQ(map.erase(1), 0u);
+    CHECK(!map.contains(1));
+    CHECK(map.contains(2));
+    CHECK_THROWS(map.at(1), std::out_of_range);
+}
+
+TEST(growsAndMatchesReference) {
+    SizeClassedPool pools(64, kMaxTableBytes);
+    FlatHashMap<std::uint64_t, std::uint64_t> map(pools);
+    std::unordered_map<std::uint64_t, std::uint64_t> reference;
+    std::uint64_t seed = 88172645463325252ull;
+    for (int i = 0; i < 20000; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        std::uint64_t key = seed % 5000;
+        if (seed & 0x100) {
+            CHECK_EQ(map.erase(key), reference.erase(key));
+        } else {
+            map.insert_or_assign(key, seed);
+            reference[key] = seed;
+        }
+    }
+    CHECK_EQ(map.size(), reference.size());
+    for (const auto& [key, value] : reference) {
+        CHECK_EQ(map.at(key), value);
+    }
+    std::size_t visited = 0;
+    for (const auto& entry : map) {
+        CHECK_EQ(reference.at(entry.first), entry.second);
+        ++visited;
+    }
+    CHECK_EQ(visited, reference.size());
+}
+
+TEST(rehashReturnsOldTableToPool) {
+    SizeClassedPool pools(64, kMaxTableBytes);
+    {
+        FlatHashMap<std::uint64_t, std::uint64_t> map(pools);
+        map.reserve(100);
+        std::size_t capacity = map.capacity();
+        for (std::uint64_t i = 0; i < 100; ++i) {
+            map[i] = i;
+        }
+        CHECK_EQ(map.capacity(), capacity);
+        map[1000] = 1; // Crosses the load limit and doubles the table
+    }
+    // Once the map is gone every table block is back in its size class
+    for (std::size_t bytes = SizeClassedPool::linearLimit * 2; bytes <= kMaxTableBytes; bytes *= 2) {
+        MemoryPool& pool = pools.poolFor(bytes);
+        CHECK_EQ(pool.getAvailableCount(), pool.getCapacity());
+    }
+}
+
+TEST(tombstonesTriggerSameSizeRehash) {
+    SizeClassedPool pools(64, kMaxTableBytes);
+    FlatHashMap<std::uint64_t, int> map(pools);
+    map.reserve(50);
+    std::size_t capacity = map.capacity();
+    for (std::uint64_t round = 0; round < 100; ++round) {
+        for (std::uint64_t i = 0; i < 40; ++i) {
+            map[round * 100 + i] = 1;
+        }
+        for (std::uint64_t i = 0; i < 40; ++i) {
+            map.erase(round * 100 + i);
+        }
+    }
+    CHECK(map.empty());
+    CHECK_EQ(map.capacity(), capacity);
+}
+
+TEST(copyMoveAndClear) {
+    SizeClassedPool pools(64, kMaxTableBytes);
+    FlatHashMap<int, std::string> map(pools);
+    for (int i = 0; i < 50; ++i) {
+        map[i] = std::to_string(i);
+    }
+    FlatHashMap<int, std::string> copy(map);
+    FlatHashMap<int, std::string> moved(std::move(map));
+    CHECK(map.empty());
+    CHECK_EQ(copy.size(), 50u);
+    CHECK_EQ(moved.at(42), "42");
+    moved.clear();
+    CHECK(moved.empty());
+    CHECK(moved.find(42) == moved.end());
+    moved[7] = "seven";
+    CHECK_EQ(moved.size(), 1u);
+}
+
+// Large tables get few blocks per size class; clearing tombstones must not
+// need a second table of the same class
+TEST(largeTableChurnRehashesInPlace) {
+    SizeClassedPool pools(64, kMaxTableBytes);
+    FlatHashMap<std::uint64_t, std::uint64_t> map(pools);
+    map.reserve(800);
+    std::size_t capacity = map.capacity();
+    constexpr std::uint64_t kLive = 500;
+    for (std::uint64_t key = 0; key < 100000; ++key) {
+        map[key] = key;
+        if (key >= kLive) {
+            CHECK_EQ(map.erase(key - kLive), 1u);
+        }
+    }
+    CHECK_EQ(map.capacity(), capacity);
+    CHECK_EQ(map.size(), kLive);
+    for (std::uint64_t key = 100000 - kLive; key < 100000; ++key) {
+        CHECK_EQ(map.at(key), key);
+    }
+    CHECK(!map.contains(100000 - kLive - 1));
+}
+
+TEST(twoMapsGrowSideBySide) {
+    SizeClassedPool pools(64, kMaxTableBytes);
+    {
+        FlatHashMap<std::uint64_t, std::uint64_t> a(pools);
+        FlatHashMap<std::uint64_t, std::uint64_t> b(pools);
+        for (std::uint64_t key = 0; key < 3000; ++key) {
+            a[key] = key;
+            b[key] = ~key;
+        }
+        CHECK_EQ(a.capacity(), b.capacity());
+        for (std::uint64_t key = 0; key < 3000; ++key) {
+            CHECK_EQ(a.at(key), key);
+            CHECK_EQ(b.at(key), ~key);
+        }
+    }
+    for (std::size_t bytes = SizeClassedPool::linearLimit * 2; bytes <= pools.getMaxPooledSize(); bytes *= 2) {
+        MemoryPool& pool = pools.poolFor(bytes);
+        CHECK_EQ(pool.getAvailableCount(), pool.getCapacity());
+    }
+}
@@ -0,0 +1,210 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "HazardDomain.hpp"
+#include "MemoryPool.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+struct Node {
+    long value;
+    Node* next;
+};
+
+// Treiber stack whose popped nodes go through the hazard domain
+class Stack {
+private:
+    std::atomic<Node*> head{nullptr};
+    HazardDomain<>& domain;
+
+public:
+    explicit Stack(HazardDomain<>& domain) : domain(domain) {}
+
+    void push(long value) {
+        Node* node = new (domain.allocate()) Node{value, head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool pop(long& value) {
+        auto hazard = domain.makeHazard();
+        Node* node;
+        do {
+            node = hazard.protect(head);
+            if (node == nullptr) {
+                return false;
+            }
+        } while (!head.compare_exchange_weak(node, node->next, std::memory_order_acquire, std::memory_order_relaxed));
+        value = node->value;
+        hazard.reset();
+        domain.retire(static_cast<void*>(node));
+        return true;
+    }
+};
+
+struct Counted {
+    static int live;
+    Counted() { ++live; }
+    ~Counted() { --live; }
+};
+
+int Counted::live = 0;
+
+} // namespace
+
+TEST(protectedNodeSurvivesScan) {
+    MemoryPool pool(sizeof(Node), 4);
+    HazardDomain<> domain(pool);
+    std::atomic<Node*> shared{new (domain.allocate()) Node{1, nullptr}};
+    void* other = domain.allocate();
+    {
+        auto hazard = domain.makeHazard();
+        Node* node = hazard.protect(shared);
+        CHECK(node == shared.load());
+        domain.retire(static_cast<void*>(node));
+        domain.retire(other);
+        CHECK_EQ(domain.collect(), 1u); // Only the unprotected block
+        CHECK_EQ(pool.getAvailableCount(), 3u);
+        CHECK_EQ(domain.getPendingCount(), 1u);
+    }
+    CHECK_EQ(domain.collect(), 1u);
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+    CHECK_EQ(domain.getReclaimedCount(), 2u);
+}
+
+TEST(retiredListStaysWithinBound) {
+    MemoryPool pool(sizeof(Node), 64);
+    HazardDomain<> domain(pool, 8);
+    std::atomic<Node*> shared{new (domain.allocate()) Node{0, nullptr}};
+    auto hazard = domain.makeHazard();
+    hazard.protect(shared);
+    domain.retire(static_cast<void*>(shared.load()));
+    for (int i = 0; i < 50; ++i) {
+        domain.retire(domain.allocate());
+        CHECK(domain.getPendingCount() < domain.getRetiredBound());
+    }
+    // A protected node is kept by every scan
+    CHECK_EQ(pool.getAvailableCount(), 63u - domain.getPendingCount() + 1u);
+}
+
+TEST(hazardOnAnotherThreadBlocksReclamation) {
+    MemoryPool pool(sizeof(Node), 4);
+    HazardDomain<> domain(pool);
+    std::atomic<Node*> shared{new (domain.allocate()) Node{7, nullptr}};
+    std::atomic<int> phase{0};
+    std::thread reader([&] {
+        auto hazard = domain.makeHazard();
+        Node* node = hazard.protect(shared);
+        phase = 1;
+        while (phase.load() != 2) {
+            std::this_thread::yield();
+        }
+        CHECK_EQ(node->value, 7);
+    });
+    while (phase.load() != 1) {
+        std::this_thread::yield();
+    }
+    Node* old = shared.exchange(nullptr);
+    domain.retire(static_cast<void*>(old));
+    CHECK_EQ(domain.collect(), 0u);
+    CHECK_EQ(pool.getAvailableCount(), 3u);
+    phase = 2;
+    reader.join();
+    CHECK_EQ(domain.collect(), 1u);
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+}
+
+TEST(slotsPerThreadAreLimited) {
+    MemoryPool pool(sizeof(Node), 1);
+    HazardDomain<> domain(pool);
+    std::vector<HazardDomain<>::Hazard> hazards;
+    for (std::size_t i = 0; i < hazard_detail::slotsPerThread; ++i) {
+        hazards.push_back(domain.makeHazard());
+    }
+    CHECK_THROWS(domain.makeHazard(), std::length_error);
+    hazards.pop_back();
+    auto again = domain.makeHazard(); // A released slot can be taken again
+}
+
+TEST(retireRunsDestructor) {
+    MemoryPool pool(sizeof(Counted), 2);
+    {
+        HazardDomain<> domain(pool);
+        domain.retire(new (domain.allocate()) Counted());
+        CHECK_EQ(Counted::live, 1);
+    } // The domain reclaims what is left
+    CHECK_EQ(Counted::live, 0);
+    CHECK_EQ(pool.getAvailableCount(), 2u);
+}
+
+TEST(exitingThreadScansAndLeavesProtectedNodesOnItsRecord) {
+    MemoryPool pool(sizeof(Node), 8);
+    HazardDomain<> domain(pool, 1000);
+    std::atomic<Node*> shared{new (domain.allocate()) Node{1, nullptr}};
+    auto hazard = domain.makeHazard();
+    hazard.protect(shared);
+    std::thread worker([&] {
+        domain.retire(static_cast<void*>(shared.exchange(nullptr)));
+        for (int i = 0; i < 3; ++i) {
+            domain.retire(domain.allocate());
+        }
+    });
+    worker.join();
+    CHECK_EQ(pool.getAvailableCount(), 7u); // Only the protected node is kept
+    hazard.reset();
+    std::thread heir([&] {
+        CHECK_EQ(domain.getPendingCount(), 1u); // Took over the exited thread's record
+        CHECK_EQ(domain.collect(), 1u);
+    });
+    heir.join();
+    CHECK_EQ(pool.getAvailableCount(), 8u);
+}
+
+// Short-lived threads that retire and exit must not pile up retired nodes
+TEST(boundCoversExitedThreads) {
+    MemoryPool pool(sizeof(Node), 64);
+    HazardDomain<> domain(pool, 32);
+    for (int generation = 0; generation < 200; ++generation) {
+        std::thread([&] {
+            for (int i = 0; i < 20; ++i) {
+                domain.retire(domain.allocate());
+            }
+        }).join();
+    }
+    CHECK_EQ(domain.getReclaimedCount(), 4000u);
+    CHECK_EQ(pool.getAvailableCount(), 64u);
+}
+
+TEST(concurrentStackReclaimsEveryNode) {
+    constexpr int threads = 4;
+    constexpr int perThread = 5000;
+    MemoryPool pool(sizeof(Node), threads * perThread);
+    HazardDomain<> domain(pool, 32);
+    Stack stack(domain);
+    std::atomic<long> popped{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < perThread; ++i) {
+                stack.push(t * perThread + i);
+                long value;
+                if (stack.pop(value)) {
+                    popped.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    long value;
+    while (stack.pop(value)) {
+        popped.fetch_add(1);
+    }
+    CHECK_EQ(popped.load(), static_cast<long>(threads * perThread));
+    domain.collect();
+    CHECK_EQ(pool.getAvailableCount(), static_cast<std::size_t>(threads * perThread));
+}
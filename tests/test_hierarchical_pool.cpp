@@ -0,0 +1,196 @@
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "HierarchicalPool.hpp"
+#include "PoolManager.hpp"
+#include "TestHarness.hpp"
+
+TEST(childDrawsChunksFromParent) {
+    HierarchicalPool root(64, 4);
+    HierarchicalPool tenant(root);
+    CHECK_EQ(root.getChildCount(), 1u);
+    CHECK(tenant.getParent() == &root);
+
+    void* first = tenant.allocate();
+    CHECK_EQ(tenant.getReservedBytes(), root.getChunkBytes());
+    CHECK_EQ(root.getReservedBytes(), root.getChunkBytes());
+    CHECK_EQ(tenant.getUsedCount(), 1u);
+    CHECK_EQ(tenant.getAvailableCount(), 3u);
+    CHECK_EQ(root.getUsedCount(), 0u);
+
+    // Lowest address first within a chunk
+    void* second = tenant.allocate();
+    CHECK(second > first);
+    tenant.deallocate(second);
+    tenant.deallocate(first);
+    CHECK_EQ(tenant.getUsedCount(), 0u);
+}
+
+TEST(usageIsReportedUpTheTree) {
+    HierarchicalPool root(32, 2);
+    HierarchicalPool department(root);
+    HierarchicalPool tenantA(department);
+    HierarchicalPool tenantB(department);
+    std::size_t chunk = root.getChunkBytes();
+
+    std::vector<void*> a;
+    for (int i = 0; i < 5; ++i) { // 3 chunks
+        a.push_back(tenantA.allocate());
+    }
+    void* b = tenantB.allocate(); // 1 chunk
+    CHECK_EQ(tenantA.getReservedBytes(), 3 * chunk);
+    CHECK_EQ(tenantB.getReservedBytes(), chunk);
+    CHECK_EQ(department.getReservedBytes(), 4 * chunk);
+    CHECK_EQ(root.getReservedBytes(), 4 * chunk);
+
+    for (void* block : a) {
+        tenantA.deallocate(block);
+    }
+    tenantB.deallocate(b);
+}
+
+TEST(hardQuotaIsolatesTenants) {
+    HierarchicalPool root(64, 4);
+    PoolQuota quota;
+    quota.hardBytes = 2 * root.getChunkBytes();
+    HierarchicalPool runaway(root, quota);
+    HierarchicalPool neighbour(root);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        blocks.push_back(runaway.allocate());
+    }
+    CHECK_THROWS(runaway.allocate(), std::bad_alloc);
+    CHECK_EQ(runaway.getReservedBytes(), 2 * root.getChunkBytes());
+
+    void* other = neighbour.allocate(); // Unaffected by the runaway tenant
+    neighbour.deallocate(other);
+    for (void* block : blocks) {
+        runaway.deallocate(block);
+    }
+}
+
+TEST(ancestorHardQuotaApplies) {
+    HierarchicalPool root(64, 1);
+    PoolQuota quota;
+    quota.hardBytes = 2 * root.getChunkBytes();
+    HierarchicalPool group(root, quota);
+    HierarchicalPool tenantA(group);
+    HierarchicalPool tenantB(group);
+
+    void* a = tenantA.allocate();
+    void* b = tenantB.allocate();
+    CHECK_THROWS(tenantA.allocate(), std::bad_alloc);
+    CHECK_EQ(tenantA.getReservedBytes(), root.getChunkBytes());
+    tenantA.deallocate(a);
+    tenantB.deallocate(b);
+}
+
+TEST(softQuotaFiresOncePerCrossing) {
+    HierarchicalPool root(64, 2);
+    PoolQuota quota;
+    quota.softBytes = root.getChunkBytes();
+    HierarchicalPool tenant(root, quota);
+    int fired = 0;
+    tenant.setSoftLimitHandler([&](HierarchicalPool& node) {
+        CHECK(&node == &tenant);
+        CHECK(node.isOverSoftLimit());
+        ++fired;
+    });
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 6; ++i) { // Soft limits never refuse chunks
+        blocks.push_back(tenant.allocate());
+    }
+    CHECK_EQ(fired, 1);
+    CHECK(tenant.isOverSoftLimit());
+
+    for (void* block : blocks) {
+        tenant.deallocate(block);
+    }
+    tenant.trim();
+    CHECK(!tenant.isOverSoftLimit());
+    for (int i = 0; i < 2; ++i) {
+        blocks[i] = tenant.allocate();
+    }
+    tenant.allocate();
+    CHECK_EQ(fired, 2);
+}
+
+TEST(trimmedChunksAreReusedBySiblings) {
+    HierarchicalPool root(64, 4);
+    HierarchicalPool tenantA(root);
+    HierarchicalPool tenantB(root);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        blocks.push_back(tenantA.allocate());
+    }
+    void* pinned = blocks[5]; // Keeps the second chunk
+    for (void* block : blocks) {
+        if (block != pinned) {
+            tenantA.deallocate(block);
+        }
+    }
+    CHECK_EQ(tenantA.trim(), root.getChunkBytes());
+    CHECK_EQ(tenantA.getReservedBytes(), root.getChunkBytes());
+    CHECK_EQ(tenantA.getAvailableCount(), 3u);
+    CHECK_EQ(root.getReservedBytes(), 2 * root.getChunkBytes());
+
+    tenantB.allocate(); // Takes the spare instead of a new chunk
+    CHECK_EQ(root.getReservedBytes(), 2 * root.getChunkBytes());
+    tenantA.deallocate(pinned);
+}
+
+TEST(destroyedChildReturnsChunks) {
+    HierarchicalPool root(64, 4);
+    {
+        HierarchicalPool tenant(root);
+        tenant.allocate();
+        CHECK_EQ(root.getChildCount(), 1u);
+    }
+    CHECK_EQ(root.getChildCount(), 0u);
+    CHECK_EQ(root.getReservedBytes(), root.getChunkBytes()); // Kept as a spare
+    CHECK_EQ(root.trim(), root.getChunkBytes());
+    CHECK_EQ(root.getReservedBytes(), 0u);
+}
+
+TEST(makeUniquePoolUsesChildPool) {
+    HierarchicalPool root(sizeof(int), 4);
+    HierarchicalPool tenant(root);
+    {
+        auto value = make_unique_pool<int>(tenant, 42);
+        CHECK_EQ(*value, 42);
+        CHECK_EQ(tenant.getUsedCount(), 1u);
+    }
+    CHECK_EQ(tenant.getUsedCount(), 0u);
+}
+
+TEST(tenantsAllocateFromSeparateThreads) {
+    HierarchicalPool root(64, 16);
+    HierarchicalPool tenantA(root);
+    HierarchicalPool tenantB(root);
+    auto churn = [](HierarchicalPool& tenant) {
+        std::vector<void*> blocks;
+        for (int round = 0; round < 200; ++round) {
+            for (int i = 0; i < 40; ++i) {
+                blocks.push_back(tenant.allocate());
+            }
+            for (void* block : blocks) {
+                tenant.deallocate(block);
+            }
+            blocks.clear();
+            tenant.trim();
+        }
+    };
+    std::thread a(churn, std::ref(tenantA));
+    std::thread b(churn, std::ref(tenantB));
+    a.join();
+    b.join();
+    CHECK_EQ(tenantA.getReservedBytes() + tenantB.getReservedBytes(), 0u);
+    root.trim();
+    CHECK_EQ(root.getReservedBytes(), 0u);
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "AllocationCounter.hpp"
+#include "IntrusiveContainers.hpp"
+#include "PoolManager.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+struct ByLevel;
+struct ByPrice;
+struct ById;
+
+// One order, indexed three ways at once
+struct Order : ListHook<ByLevel>, TreeHook<ByPrice>, HashHook<ById> {
+    std::uint64_t id;
+    int price;
+    int quantity;
+
+    Order(std::uint64_t id, int price, int quantity) : id(id), price(price), quantity(quantity) {}
+};
+
+struct PriceOrder {
+    bool operator()(const Order& a, const Order& b) const { return a.price < b.price; }
+    bool operator()(const Order& a, int price) const { return a.price < price; }
+    bool operator()(int price, const Order& b) const { return price < b.price; }
+};
+
+struct IdHash {
+    std::size_t operator()(const Order& order) const { return std::hash<std::uint64_t>()(order.id); }
+    std::size_t operator()(std::uint64_t id) const { return std::hash<std::uint64_t>()(id); }
+};
+
+struct IdEqual {
+    bool operator()(const Order& a, const Order& b) const { return a.id == b.id; }
+    bool operator()(const Order& a, std::uint64_t id) const { return a.id == id; }
+};
+
+struct Node : TreeHook<> {
+    int key;
+    explicit Node(int key) : key(key) {}
+    bool operator<(const Node& other) const { return key < other.key; }
+};
+
+} // namespace
+
+TEST(listKeepsInsertionOrder) {
+    std::vector<Order> orders;
+    for (int i = 0; i < 5; ++i) {
+        orders.emplace_back(i, 100, 1);
+    }
+    IntrusiveList<Order, ByLevel> level;
+    for (Order& order : orders) {
+        level.push_back(order);
+    }
+    level.remove(orders[2]);
+    CHECK(!orders[2].ListHook<ByLevel>::is_linked());
+    level.push_front(orders[2]);
+    std::vector<std::uint64_t> ids;
+    for (const Order& order : level) {
+        ids.push_back(order.id);
+    }
+    CHECK(ids == (std::vector<std::uint64_t>{2, 0, 1, 3, 4}));
+    level.pop_back();
+    CHECK_EQ(level.back().id, 3u);
+    IntrusiveList<Order, ByLevel> moved(std::move(level));
+    CHECK(level.empty());
+    CHECK_EQ(moved.size(), 4u);
+    CHECK_EQ((--moved.end())->id, 3u);
+    moved.clear();
+    CHECK(!orders[0].ListHook<ByLevel>::is_linked());
+}
+
+TEST(treeStaysOrderedUnderRandomInsertAndErase) {
+    std::vector<Node> nodes;
+    nodes.reserve(2000);
+    for (int i = 0; i < 2000; ++i) {
+        nodes.emplace_back(i % 700); // Duplicates too
+    }
+    std::mt19937 random(7);
+    std::shuffle(nodes.begin(), nodes.end(), random);
+    IntrusiveTree<Node> tree;
+    std::multiset<int> expected;
+    for (Node& node : nodes) {
+        tree.insert(node);
+        expected.insert(node.key);
+    }
+    for (std::size_t i = 0; i < nodes.size(); i += 3) {
+        tree.remove(nodes[i]);
+        expected.erase(expected.find(nodes[i].key));
+    }
+    CHECK_EQ(tree.size(), expected.size());
+    CHECK(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end(),
+                     [](const Node& node, int key) { return node.key == key; }));
+    CHECK_EQ(tree.front().key, *expected.begin());
+    CHECK_EQ(tree.back().key, *expected.rbegin());
+    CHECK_EQ((--tree.end())->key, *expected.rbegin());
+    CHECK(!nodes[0].is_linked());
+    CHECK(nodes[1].is_linked());
+    tree.clear();
+    CHECK(tree.empty());
+    CHECK(!nodes[1].is_linked());
+}
+
+TEST(hashTableFindsByKeyAndRehashes) {
+    std::vector<Order> orders;
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        orders.emplace_back(i, 100, 1);
+    }
+    IntrusiveHashTable<Order, ById, IdHash, IdEqual> byId(8);
+    for (Order& order : orders) {
+        CHECK(byId.insert(order).second);
+    }
+    Order duplicate(42, 1, 1);
+    auto [existing, inserted] = byId.insert(duplicate);
+    CHECK(!inserted);
+    CHECK(&*existing == &orders[42]);
+    CHECK_EQ(byId.find(std::uint64_t(42))->price, 100);
+    byId.rehash(256);
+    CHECK_EQ(byId.bucket_count(), 256u);
+    CHECK_EQ(byId.erase(std::uint64_t(7)), 1u);
+    CHECK_EQ(byId.erase(std::uint64_t(7)), 0u);
+    CHECK(!byId.contains(std::uint64_t(7)));
+    CHECK_EQ(static_cast<std::size_t>(std::distance(byId.begin(), byId.end())), 99u);
+    byId.remove(orders[8]);
+    CHECK_EQ(byId.size(), 98u);
+}
+
+TEST(hashTableErasesByIteratorAndMoves) {
+    std::vector<Order> orders;
+    for (std::uint64_t i = 0; i < 10; ++i) {
+        orders.emplace_back(i, 100, 1);
+    }
+    IntrusiveHashTable<Order, ById, IdHash, IdEqual> byId(8);
+    for (Order& order : orders) {
+        byId.insert(order);
+    }
+    byId.erase(byId.find(std::uint64_t(3)));
+    CHECK(!byId.contains(std::uint64_t(3)));
+    CHECK(!orders[3].HashHook<ById>::is_linked());
+
+    IntrusiveHashTable<Order, ById, IdHash, IdEqual> moved(std::move(byId));
+    CHECK(byId.empty());
+    CHECK(byId.begin() == byId.end());
+    CHECK(!byId.contains(std::uint64_t(4)));
+    CHECK_EQ(moved.size(), 9u);
+    CHECK(moved.contains(std::uint64_t(4)));
+
+    IntrusiveHashTable<Order, ById, IdHash, IdEqual> assigned(2);
+    assigned.insert(orders[3]);
+    assigned = std::move(moved);
+    CHECK(!orders[3].HashHook<ById>::is_linked());
+    CHECK_EQ(assigned.size(), 9u);
+    CHECK_EQ(assigned.bucket_count(), 8u);
+    byId.rehash(4);
+    CHECK(byId.insert(orders[3]).second);
+    assigned.clear();
+    byId.clear();
+}
+
+TEST(orderBookIndexesPoolObjectsWithoutAllocating) {
+    PoolManager manager(sizeof(Order), 64);
+    std::vector<std::unique_ptr<Order, std::function<void(Order*)>>> owned;
+    owned.reserve(64);
+    IntrusiveTree<Order, ByPrice, PriceOrder> byPrice;
+    IntrusiveHashTable<Order, ById, IdHash, IdEqual> byId(64);
+    IntrusiveList<Order, ByLevel> level;
+
+    for (std::uint64_t id = 0; id < 10; ++id) {
+        owned.push_back(manager.create<Order>(id, 100 + static_cast<int>(id % 3), 5));
+    }
+    std::size_t before = heapAllocations;
+    for (auto& order : owned) {
+        byPrice.insert(*order);
+        byId.insert(*order);
+        if (order->price == 101) {
+            level.push_back(*order);
+        }
+    }
+    CHECK_EQ(heapAllocations, before);
+
+    CHECK_EQ(byPrice.front().price, 100);
+    CHECK_EQ(byPrice.lower_bound(101)->id, 1u); // Equal prices keep time priority
+    CHECK_EQ(std::distance(byPrice.lower_bound(101), byPrice.upper_bound(101)), 3);
+    CHECK_EQ(level.size(), 3u);
+
+    // Cancel order 4 from every index, then free it
+    Order& cancelled = *byId.find(std::uint64_t(4));
+    byPrice.remove(cancelled);
+    level.remove(cancelled);
+    byId.remove(cancelled);
+    CHECK(!cancelled.TreeHook<ByPrice>::is_linked());
+    owned[4].reset();
+    CHECK_EQ(byPrice.size(), 9u);
+    CHECK_EQ(level.front().id, 1u);
+    CHECK_EQ(std::next(level.begin())->id, 7u);
+    CHECK(byPrice.find(103) == byPrice.end());
+
+    byPrice.clear();
+    byId.clear();
+    level.clear();
+}
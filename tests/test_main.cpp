@@ -0,0 +1,17 @@
+#include "TestHarness.hpp"
+
+int main() {
+    int failed = 0;
+    for (const TestCase& test : testRegistry()) {
+        try {
+            test.body();
+            std::cout << "[ PASS ] " << test.name << '\n';
+        } catch (const std::exception& e) {
+            ++failed;
+            std::cout << "[ FAIL ] " << test.name << ": " << e.what() << '\n';
+        }
+    }
+    std::cout << testRegistry().size() - failed << "/" << testRegistry().size()
+              << " tests passed\n";
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
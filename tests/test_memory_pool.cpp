@@ -0,0 +1,156 @@
+#include <cstdint>
+#include <cstdlib>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include "MemoryPool.hpp"
+#include "TestHarness.hpp"
+
+TEST(allocatesEveryBlockOnce) {
+    MemoryPool pool(32, 8);
+    std::set<void*> seen;
+    for (int i = 0; i < 8; ++i) {
+        CHECK(seen.insert(pool.allocate()).second);
+    }
+    CHECK(!pool.hasAvailableMemory());
+    CHECK_THROWS(pool.allocate(), std::bad_alloc);
+    for (void* block : seen) {
+        pool.deallocate(block);
+    }
+    CHECK_EQ(pool.getAvailableCount(), 8u);
+}
+
+TEST(reusesMostRecentlyFreedBlock) {
+    MemoryPool pool(16, 4);
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    pool.deallocate(a);
+    CHECK_EQ(pool.allocate(), a);
+    pool.deallocate(a);
+    pool.deallocate(b);
+}
+
+TEST(reportsGeometry) {
+    MemoryPool pool(64, 3);
+    CHECK_EQ(pool.getBlockSize(), 64u);
+    CHECK_EQ(pool.getCapacity(), 3u);
+    CHECK_EQ(pool.getAvailableCount(), 3u);
+}
+
+namespace {
+
+// Unique scratch file removed when the test finishes
+struct TempFile {
+    std::string path;
+
+    TempFile() {
+        char name[] = "/tmp/mpm_pool_XXXXXX";
+        int fd = mkstemp(name);
+        close(fd);
+        path = name;
+        unlink(name); // Start from a missing file, as on first boot
+    }
+
+    ~TempFile() {
+        unlink(path.c_str());
+    }
+};
+
+struct PersistentNode {
+    std::uint64_t next; // Offset of the next node, 0 ends the list
+    std::uint64_t value;
+};
+
+} // namespace
+
+TEST(fileBackedPoolAllocatesInAddressOrder) {
+    TempFile file;
+    MemoryPool pool(sizeof(PersistentNode), 4, file.path);
+    CHECK(pool.isFileBacked());
+    CHECK(!pool.wasRestored());
+    auto* first = static_cast<unsigned char*>(pool.allocate());
+    auto* second = static_cast<unsigned char*>(pool.allocate());
+    CHECK(second > first);
+    CHECK_EQ(pool.getAvailableCount(), 2u);
+    pool.deallocate(first);
+    CHECK_EQ(pool.allocate(), first);
+}
+
+TEST(fileBackedPoolResumesAfterRemap) {
+    TempFile file;
+    {
+        MemoryPool pool(sizeof(PersistentNode), 16, file.path);
+        std::uint64_t head = 0;
+        for (std::uint64_t i = 0; i < 5; ++i) {
+            auto* node = static_cast<PersistentNode*>(pool.allocate());
+            node->next = head;
+            node->value = i * 10;
+            head = pool.toOffset(node);
+        }
+        pool.setRoot(pool.fromOffset(head));
+        pool.sync();
+    }
+
+    MemoryPool pool(sizeof(PersistentNode), 16, file.path);
+    CHECK(pool.wasRestored());
+    CHECK_EQ(pool.getAvailableCount(), 11u);
+    std::uint64_t expected = 40;
+    std::uint64_t count = 0;
+    for (auto* node = static_cast<PersistentNode*>(pool.getRoot()); node != nullptr;
+         node = static_cast<PersistentNode*>(pool.fromOffset(node->next))) {
+        CHECK_EQ(node->value, expected);
+        expected -= 10;
+        ++count;
+    }
+    CHECK_EQ(count, 5u);
+}
+
+TEST(fileBackedPoolRejectsDifferentGeometry) {
+    TempFile file;
+    { MemoryPool pool(32, 8, file.path); }
+    CHECK_THROWS(MemoryPool(64, 8, file.path), std::invalid_argument);
+    CHECK_THROWS(MemoryPool(4, 8, file.path + ".small"), std::invalid_argument);
+}
+
+TEST(offsetsAndRootNeedAFileBackedPool) {
+    MemoryPool pool(16, 2);
+    void* block = pool.allocate();
+    CHECK_THROWS(pool.toOffset(block), std::logic_error);
+    CHECK_THROWS(pool.fromOffset(64), std::logic_error);
+    CHECK_THROWS(pool.setRoot(block), std::logic_error);
+    CHECK_THROWS(pool.getRoot(), std::logic_error);
+    pool.deallocate(block);
+}
+
+TEST(alignedBlocks) {
+    MemoryPool pool(100, 4, 256);
+    for (int i = 0; i < 4; ++i) {
+        CHECK_EQ(reinterpret_cast<std::uintptr_t>(pool.allocate()) % 256, 0u);
+    }
+}
+
+TEST(contiguousModeCarvesOneSlab) {
+    MemoryPool pool(24, 4, ContiguousBlocks{});
+    CHECK(pool.isContiguous());
+    auto* first = static_cast<unsigned char*>(pool.allocate());
+    auto* second = static_cast<unsigned char*>(pool.allocate());
+    CHECK_EQ(static_cast<std::size_t>(second - first), alignof(std::max_align_t) * 2); // 24 rounded up to 32
+    CHECK(pool.owns(first));
+    CHECK(pool.owns(second));
+    int outside = 0;
+    CHECK(!pool.owns(&outside));
+    pool.deallocate(first);
+    pool.deallocate(second);
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+}
+
+TEST(heapModeOwnsNothing) {
+    MemoryPool pool(16, 2);
+    void* block = pool.allocate();
+    CHECK(!pool.isContiguous());
+    CHECK(!pool.owns(block));
+    pool.deallocate(block);
+}
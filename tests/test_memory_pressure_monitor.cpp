@@ -0,0 +1,101 @@
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "MemoryPool.hpp"
+#include "MemoryPressureMonitor.hpp"
+#include "TestHarness.hpp"
+
+TEST(staysQuietAboveWatermarks) {
+    MemoryPool pool(16, 10);
+    MemoryPressureMonitor<> monitor(pool, 4, 1);
+    int calls = 0;
+    monitor.onPressure([&](PressureLevel, std::size_t) { ++calls; });
+    void* block = pool.allocate();
+    CHECK(monitor.poll() == PressureLevel::normal);
+    CHECK_EQ(calls, 0);
+    pool.deallocate(block);
+}
+
+TEST(escalationNotifiesImmediately) {
+    MemoryPool pool(16, 10);
+    MemoryPressureMonitor<> monitor(pool, 4, 1, std::chrono::hours(1));
+    std::vector<PressureLevel> seen;
+    std::vector<std::size_t> available;
+    monitor.onPressure([&](PressureLevel level, std::size_t free) {
+        seen.push_back(level);
+        available.push_back(free);
+    });
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 6; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    CHECK(monitor.poll() == PressureLevel::low);
+    blocks.push_back(pool.allocate());
+    CHECK(monitor.poll() == PressureLevel::low); // Rate-limited repeat
+    for (int i = 0; i < 2; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    CHECK(monitor.poll() == PressureLevel::critical);
+    CHECK(monitor.getLevel() == PressureLevel::critical);
+
+    CHECK_EQ(seen.size(), 2u);
+    CHECK(seen[0] == PressureLevel::low);
+    CHECK(seen[1] == PressureLevel::critical);
+    CHECK_EQ(available[0], 4u);
+    CHECK_EQ(available[1], 1u);
+    for (void* block : blocks) {
+        pool.deallocate(block);
+    }
+}
+
+TEST(repeatsAndRecoversAfterInterval) {
+    MemoryPool pool(16, 4);
+    MemoryPressureMonitor<> monitor(pool, 2, 0, std::chrono::milliseconds(1));
+    std::vector<PressureLevel> seen;
+    monitor.onPressure([&](PressureLevel level, std::size_t) { seen.push_back(level); });
+
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    monitor.poll();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    monitor.poll(); // Still low: callbacks run again so caches keep shedding
+    pool.deallocate(a);
+    pool.deallocate(b);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    CHECK(monitor.poll() == PressureLevel::normal);
+    monitor.poll(); // Back to normal was already reported
+
+    CHECK_EQ(seen.size(), 3u);
+    CHECK(seen[0] == PressureLevel::low);
+    CHECK(seen[1] == PressureLevel::low);
+    CHECK(seen[2] == PressureLevel::normal);
+    CHECK_EQ(monitor.getNotificationCount(), 3u);
+}
+
+TEST(callbackCanRelieveThePool) {
+    MemoryPool pool(16, 8);
+    MemoryPressureMonitor<> monitor(pool, 2, 0);
+    std::vector<void*> cache;
+    monitor.onPressure([&](PressureLevel level, std::size_t) {
+        if (level != PressureLevel::normal) {
+            while (!cache.empty()) { // Shed the cache
+                pool.deallocate(cache.back());
+                cache.pop_back();
+            }
+        }
+    });
+    for (int i = 0; i < 6; ++i) {
+        cache.push_back(pool.allocate());
+    }
+    monitor.poll();
+    CHECK(cache.empty());
+    CHECK_EQ(pool.getAvailableCount(), 8u);
+}
+
+TEST(rejectsInvertedWatermarks) {
+    MemoryPool pool(16, 8);
+    CHECK_THROWS(MemoryPressureMonitor<>(pool, 1, 2), std::invalid_argument);
+}
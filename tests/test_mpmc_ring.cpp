@@ -0,0 +1,89 @@
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "MpmcRing.hpp"
+#include "TestHarness.hpp"
+
+TEST(capacityMustBeAPowerOfTwo) {
+    CHECK_THROWS(MpmcRing<int>(0), std::invalid_argument);
+    CHECK_THROWS(MpmcRing<int>(6), std::invalid_argument);
+    MpmcRing<int> ring(8);
+    CHECK_EQ(ring.getCapacity(), 8u);
+}
+
+TEST(fifoUntilFull) {
+    MpmcRing<int> ring(4);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(ring.tryPush(i));
+    }
+    CHECK(!ring.tryPush(4));
+    CHECK_EQ(ring.getSize(), 4u);
+    int value = -1;
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            CHECK(ring.tryPop(value));
+            CHECK_EQ(value, lap * 4 + i);
+            CHECK(ring.tryPush(lap * 4 + i + 4)); // The freed cell serves the next lap
+        }
+    }
+    while (ring.tryPop(value)) {
+    }
+    CHECK(!ring.tryPop(value));
+    CHECK_EQ(ring.getSize(), 0u);
+}
+
+TEST(leftoverItemsAreDestroyed) {
+    auto shared = std::make_shared<int>(1);
+    {
+        MpmcRing<std::shared_ptr<int>> ring(4);
+        ring.tryPush(shared);
+        ring.tryPush(shared);
+        std::shared_ptr<int> out;
+        ring.tryPop(out);
+        CHECK_EQ(shared.use_count(), 3);
+    }
+    CHECK_EQ(shared.use_count(), 1);
+}
+
+TEST(concurrentProducersAndConsumersSeeEveryItemOnce) {
+    constexpr int producers = 3;
+    constexpr int consumers = 3;
+    constexpr int perProducer = 20000;
+    MpmcRing<int> ring(64);
+    std::vector<std::atomic<int>> seen(producers * perProducer);
+    std::atomic<int> consumed{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                while (!ring.tryPush(p * perProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            int value;
+            while (consumed.load() < producers * perProducer) {
+                if (ring.tryPop(value)) {
+                    seen[value].fetch_add(1);
+                    consumed.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    bool once = true;
+    for (std::atomic<int>& count : seen) {
+        once = once && count.load() == 1;
+    }
+    CHECK(once);
+}
@@ -0,0 +1,84 @@
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "PerCpuPool.hpp"
+#include "TestHarness.hpp"
+
+TEST(usesPerCpuCachesWhenRseqIsAvailable) {
+    PerCpuPool pool(32, 64);
+    CHECK(pool.getMode() == (per_cpu_detail::rseqAvailable() ? CacheMode::perCpu : CacheMode::perThread));
+    PerCpuPool forced(32, 64, 8, CacheMode::perThread);
+    CHECK(forced.getMode() == CacheMode::perThread);
+    CHECK_EQ(forced.getCpuCount(), 0u);
+    CHECK_THROWS(PerCpuPool(32, 64, 1), std::invalid_argument);
+}
+
+TEST(blocksAreDistinctAndComeBack) {
+    PerCpuPool pool(32, 256, 16);
+    std::set<void*> seen;
+    std::vector<void*> blocks;
+    for (int i = 0; i < 256; ++i) {
+        blocks.push_back(pool.allocate());
+        seen.insert(blocks.back());
+    }
+    CHECK_EQ(seen.size(), 256u);
+    CHECK_THROWS(pool.allocate(), std::bad_alloc);
+    for (void* block : blocks) {
+        pool.deallocate(block);
+    }
+    if (pool.getMode() == CacheMode::perCpu) {
+        // A full cache drains half of itself, so the caches stay bounded
+        CHECK(pool.getCachedCount() <= pool.getCpuCount() * pool.getBlocksPerCpu());
+        CHECK_EQ(pool.getCachedCount() + pool.getCentralAvailableCount(), 256u);
+    }
+    for (int i = 0; i < 256; ++i) {
+        blocks[i] = pool.allocate();
+    }
+    CHECK_THROWS(pool.allocate(), std::bad_alloc);
+    for (void* block : blocks) {
+        pool.deallocate(block);
+    }
+}
+
+TEST(threadsNeverShareABlock) {
+    constexpr int threads = 8;
+    constexpr int rounds = 20000;
+    PerCpuPool pool(sizeof(std::uint64_t), 512, 16);
+    std::atomic<bool> clash{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::vector<std::uint64_t*> held;
+            for (int i = 0; i < rounds; ++i) {
+                if (held.size() < 32 && (i % 3 != 0 || held.empty())) {
+                    auto* block = static_cast<std::uint64_t*>(pool.allocate());
+                    *block = static_cast<std::uint64_t>(t) << 32 | static_cast<std::uint64_t>(i);
+                    held.push_back(block);
+                } else {
+                    std::uint64_t* block = held.back();
+                    held.pop_back();
+                    if ((*block >> 32) != static_cast<std::uint64_t>(t)) {
+                        clash = true;
+                    }
+                    pool.deallocate(block);
+                }
+                std::this_thread::yield();
+            }
+            for (std::uint64_t* block : held) {
+                pool.deallocate(block);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    CHECK(!clash.load());
+    if (pool.getMode() == CacheMode::perCpu) {
+        CHECK_EQ(pool.getCachedCount() + pool.getCentralAvailableCount(), 512u);
+    }
+}
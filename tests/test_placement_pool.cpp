@@ -0,0 +1,117 @@
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "PlacementPool.hpp"
+#include "TestHarness.hpp"
+
+TEST(lifoReturnsMostRecentlyFreed) {
+    PlacementPool<LifoPlacement> pool(64, 100);
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    pool.deallocate(a);
+    pool.deallocate(b);
+    CHECK_EQ(pool.allocate(), b);
+    CHECK_EQ(pool.allocate(), a);
+}
+
+TEST(addressOrderedReturnsLowestFree) {
+    PlacementPool<AddressOrderedPlacement> pool(64, 300);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 300; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    pool.deallocate(blocks[250]);
+    pool.deallocate(blocks[70]);
+    pool.deallocate(blocks[130]);
+    CHECK_EQ(pool.allocate(), blocks[70]);
+    CHECK_EQ(pool.allocate(), blocks[130]);
+    CHECK_EQ(pool.allocate(), blocks[250]);
+    CHECK_THROWS(pool.allocate(), std::bad_alloc);
+}
+
+TEST(fullestPageFillsPartlyUsedPagesFirst) {
+    PlacementPool<FullestPagePlacement> pool(512, 64); // 8 blocks per 4 KiB page
+    std::size_t perPage = pool.getBlocksPerPage();
+    std::vector<void*> blocks;
+    for (std::size_t i = 0; i < 3 * perPage; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    CHECK_EQ(pool.getPagesInUse(), 3u);
+    // Page 0 gets one hole, page 1 is emptied apart from one block
+    pool.deallocate(blocks[2]);
+    for (std::size_t i = perPage + 1; i < 2 * perPage; ++i) {
+        pool.deallocate(blocks[i]);
+    }
+    CHECK_EQ(pool.allocate(), blocks[2]);
+    void* next = pool.allocate();
+    CHECK_EQ(pool.blockIndex(next) / perPage, 1u);
+    CHECK_EQ(pool.getPagesInUse(), 3u);
+}
+
+TEST(fullestPageKeepsLiveBlocksOnFewPages) {
+    PlacementPool<FullestPagePlacement> grouped(512, 512);
+    PlacementPool<LifoPlacement> lifo(512, 512);
+    std::vector<void*> a;
+    std::vector<void*> b;
+    for (int i = 0; i < 512; ++i) {
+        a.push_back(grouped.allocate());
+        b.push_back(lifo.allocate());
+    }
+    // Two holes in each page of the upper half, then the whole lower half
+    for (int i = 256; i < 512; i += 4) {
+        grouped.deallocate(a[i]);
+        lifo.deallocate(b[i]);
+    }
+    for (int i = 0; i < 256; ++i) {
+        grouped.deallocate(a[i]);
+        lifo.deallocate(b[i]);
+    }
+    CHECK_EQ(grouped.getPagesInUse(), 32u);
+    for (int i = 0; i < 64; ++i) {
+        grouped.allocate();
+        lifo.allocate();
+    }
+    CHECK_EQ(grouped.getPagesInUse(), 32u); // The holes were filled
+    CHECK(lifo.getPagesInUse() > 32u);
+    CHECK_EQ(grouped.getAvailableCount(), lifo.getAvailableCount());
+}
+
+TEST(cacheColoringShiftsBlockStarts) {
+    PlacementPool<LifoPlacement> colored(1000, 64, true);
+    PlacementPool<LifoPlacement> plain(1000, 64);
+    CHECK_EQ(plain.getColorCount(), 1u);
+    CHECK(colored.getColorCount() > 1);
+    std::size_t perPage = colored.getBlocksPerPage();
+    std::set<std::uintptr_t> offsets;
+    for (std::uint32_t page = 0; page < colored.getColorCount(); ++page) {
+        auto address = reinterpret_cast<std::uintptr_t>(colored.blockAt(page * perPage));
+        offsets.insert(address % colored.getPageBytes());
+    }
+    CHECK_EQ(offsets.size(), colored.getColorCount());
+
+    // Every block maps back to its own index
+    for (std::uint32_t index = 0; index < 64; ++index) {
+        CHECK_EQ(colored.blockIndex(colored.blockAt(index)), index);
+        auto end = reinterpret_cast<std::uintptr_t>(colored.blockAt(index)) + 1000;
+        auto pageEnd = reinterpret_cast<std::uintptr_t>(colored.blockAt(index / perPage * perPage)) /
+                           colored.getPageBytes() * colored.getPageBytes() + colored.getPageBytes();
+        CHECK(end <= pageEnd);
+    }
+}
+
+TEST(blocksLargerThanAPageGetBiggerPages) {
+    PlacementPool<AddressOrderedPlacement> pool(5000, 10);
+    CHECK_EQ(pool.getPageBytes(), 8192u);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 10; ++i) {
+        blocks.push_back(pool.allocate());
+        CHECK_EQ(pool.blockIndex(blocks.back()), static_cast<std::uint32_t>(i));
+    }
+}
+
+TEST(rejectsEmptyGeometry) {
+    CHECK_THROWS(PlacementPool<LifoPlacement>(0, 10), std::invalid_argument);
+    CHECK_THROWS(PlacementPool<LifoPlacement>(16, 0), std::invalid_argument);
+}
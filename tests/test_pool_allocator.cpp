@@ -0,0 +1,44 @@
+#include <vector>
+
+#include "PoolAllocator.hpp"
+#include "TestHarness.hpp"
+
+TEST(vectorGrowsWithinBlock) {
+    MemoryPool pool(16 * sizeof(int), 4);
+    std::vector<int, PoolAllocator<int>> values{PoolAllocator<int>(pool)};
+    for (int i = 0; i < 16; ++i) {
+        values.push_back(i);
+    }
+    CHECK_EQ(values.size(), 16u);
+    CHECK_EQ(values[15], 15);
+}
+
+TEST(rejectsRequestLargerThanBlock) {
+    MemoryPool pool(4 * sizeof(int), 4);
+    PoolAllocator<int> allocator(pool);
+    CHECK_THROWS(allocator.allocate(5), std::bad_alloc);
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+}
+
+TEST(reboundAllocatorsCompareEqual) {
+    MemoryPool pool(64, 2);
+    PoolAllocator<int> ints(pool);
+    PoolAllocator<double> doubles(ints);
+    CHECK(ints == doubles);
+
+    MemoryPool other(64, 2);
+    CHECK(ints != PoolAllocator<int>(other));
+}
+
+TEST(rebindResolvesToSizeClass) {
+    SizeClassedPool pools(4);
+    PoolAllocator<char> chars(pools);
+    PoolAllocator<long double> wide(chars);
+    CHECK_EQ(&chars.getPool(), &pools.poolFor(sizeof(char)));
+    CHECK_EQ(&wide.getPool(), &pools.poolFor(sizeof(long double)));
+    CHECK(chars == wide);
+
+    long double* value = wide.allocate(1);
+    CHECK_EQ(wide.getPool().getAvailableCount(), 3u);
+    wide.deallocate(value, 1);
+}
@@ -0,0 +1,45 @@
+#include <string>
+
+#include "PoolContainers.hpp"
+#include "TestHarness.hpp"
+
+TEST(mapNodesComeFromNodeSizedPool) {
+    SizeClassedPool pools(64);
+    {
+        pool_map<int, std::string> map(pools);
+        for (int i = 0; i < 32; ++i) {
+            map.emplace(i, std::to_string(i));
+        }
+        CHECK_EQ(map.size(), 32u);
+        CHECK_EQ(map.at(17), "17");
+    }
+    // Every node class is full again once the map is gone
+    for (std::size_t bytes = SizeClassedPool::granularity; bytes <= SizeClassedPool::linearLimit;
+         bytes += SizeClassedPool::granularity) {
+        CHECK_EQ(pools.poolFor(bytes).getAvailableCount(), 64u);
+    }
+}
+
+TEST(unorderedMapSurvivesRehash) {
+    SizeClassedPool pools(256);
+    pool_unordered_map<long, long> map(pools);
+    for (long i = 0; i < 200; ++i) {
+        map[i] = i * i;
+    }
+    CHECK_EQ(map.size(), 200u);
+    CHECK_EQ(map.at(150), 150 * 150);
+    map.clear();
+    CHECK(map.empty());
+}
+
+TEST(listUsesSingleNodeClass) {
+    SizeClassedPool pools(8);
+    pool_list<double> list(pools);
+    for (int i = 0; i < 8; ++i) {
+        list.push_back(i);
+    }
+    CHECK_THROWS(list.push_back(9), std::bad_alloc);
+    list.pop_front();
+    list.push_back(9);
+    CHECK_EQ(list.back(), 9.0);
+}
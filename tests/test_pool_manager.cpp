@@ -0,0 +1,173 @@
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PoolManager.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+struct Tracked {
+    static int live;
+    int value;
+
+    explicit Tracked(int value) : value(value) { ++live; }
+    ~Tracked() { --live; }
+};
+
+int Tracked::live = 0;
+
+struct Throwing {
+    Throwing() { throw std::runtime_error("constructor failed"); }
+};
+
+} // namespace
+
+TEST(createConstructsAndDestroys) {
+    PoolManager manager(sizeof(Tracked), 2);
+    {
+        auto object = manager.create<Tracked>(7);
+        CHECK_EQ(object->value, 7);
+        CHECK_EQ(Tracked::live, 1);
+        CHECK_EQ(manager.pool.getAvailableCount(), 1u);
+    }
+    CHECK_EQ(Tracked::live, 0);
+    CHECK_EQ(manager.pool.getAvailableCount(), 2u);
+}
+
+TEST(createRejectsOversizedType) {
+    PoolManager manager(sizeof(int), 2);
+    CHECK_THROWS(manager.create<std::string>("too big"), std::bad_alloc);
+    CHECK_EQ(manager.pool.getAvailableCount(), 2u);
+}
+
+TEST(createReturnsBlockWhenConstructorThrows) {
+    PoolManager manager(sizeof(Throwing), 1);
+    CHECK_THROWS(manager.create<Throwing>(), std::runtime_error);
+    CHECK_EQ(manager.pool.getAvailableCount(), 1u);
+}
+
+TEST(fallsBackThroughOverflowToHeap) {
+    FallbackChain chain;
+    chain.overflowChunkBlocks = 2;
+    chain.overflowMaxChunks = 1;
+    chain.heap = true;
+    PoolManager manager(32, 2, chain);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 6; ++i) {
+        blocks.push_back(manager.allocate());
+    }
+    CHECK(manager.tierOf(blocks[0]) == PoolTier::central);
+    CHECK(manager.tierOf(blocks[2]) == PoolTier::overflow);
+    CHECK(manager.tierOf(blocks[3]) == PoolTier::overflow);
+    CHECK(manager.tierOf(blocks[4]) == PoolTier::heap);
+    CHECK_EQ(manager.getTierHits(PoolTier::central), 2u);
+    CHECK_EQ(manager.getTierHits(PoolTier::overflow), 2u);
+    CHECK_EQ(manager.getTierHits(PoolTier::heap), 2u);
+    CHECK_EQ(manager.getOverflowChunkCount(), 1u);
+
+    // Each block is routed back to its own tier
+    for (void* block : blocks) {
+        manager.deallocate(block);
+    }
+    CHECK_EQ(manager.pool.getAvailableCount(), 2u);
+    void* reused = manager.allocate();
+    void* again = manager.allocate();
+    void* overflow = manager.allocate();
+    CHECK(manager.tierOf(overflow) == PoolTier::overflow);
+    CHECK_EQ(manager.getOverflowChunkCount(), 1u);
+    manager.deallocate(reused);
+    manager.deallocate(again);
+    manager.deallocate(overflow);
+}
+
+TEST(chainWithoutHeapStillThrows) {
+    FallbackChain chain;
+    chain.overflowChunkBlocks = 1;
+    chain.overflowMaxChunks = 1;
+    PoolManager manager(16, 1, chain);
+    void* a = manager.allocate();
+    void* b = manager.allocate();
+    CHECK_THROWS(manager.allocate(), std::bad_alloc);
+    manager.deallocate(a);
+    manager.deallocate(b);
+}
+
+TEST(createUsesTheChain) {
+    FallbackChain chain;
+    chain.heap = true;
+    PoolManager manager(sizeof(Tracked), 1, chain);
+    {
+        auto first = manager.create<Tracked>(1);
+        auto second = manager.create<Tracked>(2);
+        CHECK(manager.tierOf(second.get()) == PoolTier::heap);
+        CHECK_EQ(Tracked::live, 2);
+    }
+    CHECK_EQ(Tracked::live, 0);
+    CHECK_EQ(manager.pool.getAvailableCount(), 1u);
+}
+
+TEST(threadCacheServesRepeatAllocations) {
+    FallbackChain chain;
+    chain.threadCacheBlocks = 4;
+    PoolManager manager(64, 16, chain);
+    for (int i = 0; i < 10; ++i) {
+        void* block = manager.allocate();
+        manager.deallocate(block);
+    }
+    CHECK_EQ(manager.getTierHits(PoolTier::central), 1u); // One refill
+    CHECK_EQ(manager.getTierHits(PoolTier::threadCache), 9u);
+    CHECK_EQ(manager.pool.getAvailableCount(), 14u); // Batch of two cached
+}
+
+TEST(threadCachesFlushOnThreadExit) {
+    FallbackChain chain;
+    chain.threadCacheBlocks = 8;
+    chain.heap = true;
+    PoolManager manager(64, 64, chain);
+    auto worker = [&manager] {
+        std::vector<void*> blocks;
+        for (int round = 0; round < 100; ++round) {
+            for (int i = 0; i < 20; ++i) {
+                blocks.push_back(manager.allocate());
+            }
+            for (void* block : blocks) {
+                manager.deallocate(block);
+            }
+            blocks.clear();
+        }
+    };
+    std::thread a(worker);
+    std::thread b(worker);
+    a.join();
+    b.join();
+    CHECK_EQ(manager.pool.getAvailableCount(), 64u);
+    CHECK(manager.getTierHits(PoolTier::threadCache) > 0);
+    CHECK_EQ(manager.getTierHits(PoolTier::threadCache) + manager.getTierHits(PoolTier::central) +
+                 manager.getTierHits(PoolTier::heap),
+             4000u);
+}
+
+// A stats reader must not take the registry lock under the manager's mutex,
+// which exiting threads take in the other order
+TEST(tierHitsCanBeReadWhileThreadsExit) {
+    FallbackChain chain;
+    chain.threadCacheBlocks = 4;
+    PoolManager manager(64, 64, chain);
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        while (!done.load()) {
+            manager.getTierHits(PoolTier::central);
+        }
+    });
+    for (int i = 0; i < 200; ++i) {
+        std::thread([&manager] { manager.deallocate(manager.allocate()); }).join();
+    }
+    done = true;
+    reader.join();
+    CHECK_EQ(manager.getTierHits(PoolTier::threadCache) + manager.getTierHits(PoolTier::central), 200u);
+    CHECK_EQ(manager.pool.getAvailableCount(), 64u);
+}
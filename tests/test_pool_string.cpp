@@ -0,0 +1,74 @@
+#include <new>
+#include <string>
+#include <string_view>
+
+#include "PoolString.hpp"
+#include "TestHarness.hpp"
+
+TEST(poolStringHeapPartComesFromItsSizeClass) {
+    SizeClassedPool pools(8);
+    {
+        pool_string small("short", pools);
+        CHECK_EQ(pools.poolFor(32).getAvailableCount(), 8u); // Fits the inline buffer
+        pool_string longer("a string well past the small-string buffer", pools);
+        CHECK_EQ(pools.poolFor(48).getAvailableCount(), 7u);
+        longer += small;
+        std::string_view view = longer; // No copy
+        CHECK(view.data() == longer.data());
+        CHECK(view.substr(view.size() - 5) == "short");
+    }
+    CHECK_EQ(pools.poolFor(48).getAvailableCount(), 8u);
+}
+
+TEST(arenaCopiesShareChunks) {
+    StringArena arena(64, 4);
+    std::string_view a = arena.copy("hello");
+    std::string_view b = arena.copy("world");
+    CHECK(a == "hello");
+    CHECK(b == "world");
+    CHECK(b.data() == a.data() + a.size()); // Bump allocated back to back
+    CHECK_EQ(arena.getChunkCount(), 1u);
+    CHECK_EQ(arena.getBytesUsed(), 10u);
+    CHECK(arena.copy("").empty());
+}
+
+TEST(internReturnsOneCopyPerDistinctString) {
+    StringArena arena;
+    std::string first = "GET";
+    std::string second = "GET";
+    std::string_view a = arena.intern(first);
+    std::string_view b = arena.intern(second);
+    std::string_view c = arena.intern("POST");
+    CHECK(a.data() == b.data());
+    CHECK(a.data() != first.data());
+    CHECK(c == "POST");
+    CHECK_EQ(arena.getInternedCount(), 2u);
+}
+
+TEST(resetReturnsChunksToThePool) {
+    StringArena arena(32, 2);
+    arena.copy(std::string(20, 'x'));
+    arena.copy(std::string(20, 'y')); // Second chunk
+    CHECK_EQ(arena.getChunkCount(), 2u);
+    CHECK_THROWS(arena.copy(std::string(20, 'z')), std::bad_alloc);
+    std::string_view big = arena.copy(std::string(100, 'b')); // Larger than a chunk
+    CHECK_EQ(big.size(), 100u);
+    arena.reset();
+    CHECK_EQ(arena.getChunkCount(), 0u);
+    CHECK_EQ(arena.getBytesUsed(), 0u);
+    arena.intern("again");
+    CHECK_EQ(arena.getInternedCount(), 1u);
+}
+
+TEST(arenaStringBuildsInPlace) {
+    StringArena arena;
+    arena_string line(arena);
+    for (int i = 0; i < 20; ++i) {
+        line += "field=";
+        line += std::to_string(i);
+        line += ' ';
+    }
+    std::string_view view = line;
+    CHECK(view.substr(0, 8) == "field=0 ");
+    CHECK(arena.getBytesUsed() > 0u);
+}
@@ -0,0 +1,103 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "RegisteredBufferPool.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+// io_uring may be disabled (seccomp, io_uring_disabled sysctl); those hosts skip
+std::unique_ptr<IoUring> makeRing() {
+    try {
+        return std::make_unique<IoUring>(16);
+    } catch (const std::system_error& e) {
+        std::cout << "  io_uring unavailable, skipping: " << e.what() << '\n';
+        return nullptr;
+    }
+}
+
+} // namespace
+
+TEST(blocksMapToFixedBufferIndexes) {
+    auto ring = makeRing();
+    if (!ring) {
+        return;
+    }
+    RegisteredBufferPool pool(*ring, 1000, 4);
+    void* first = pool.allocate();
+    void* second = pool.allocate();
+    CHECK_EQ(pool.bufferIndex(first), 0u);
+    CHECK_EQ(pool.bufferIndex(second), 1u);
+    CHECK_EQ(pool.bufferAt(1), second);
+    CHECK_EQ(pool.getBlockSize() % 4096, 0u);
+    pool.deallocate(first);
+    CHECK_EQ(pool.allocate(), first);
+}
+
+TEST(fixedWriteAndReadAgainstFile) {
+    auto ring = makeRing();
+    if (!ring) {
+        return;
+    }
+    RegisteredBufferPool pool(*ring, 4096, 4);
+    char path[] = "/tmp/mpm_uring_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    unlink(path);
+
+    auto* out = static_cast<char*>(pool.allocate());
+    std::strcpy(out, "written from a registered buffer");
+    unsigned length = static_cast<unsigned>(std::strlen(out));
+    pool.prepareWriteFixed(ring->getSqe(), fd, out, length, 0);
+    ring->submit();
+    CHECK_EQ(ring->waitCqe().res, static_cast<int>(length));
+
+    auto* in = static_cast<char*>(pool.allocate());
+    pool.prepareReadFixed(ring->getSqe(), fd, in, 4096, 0);
+    ring->submit();
+    CHECK_EQ(ring->waitCqe().res, static_cast<int>(length));
+    CHECK_EQ(std::string(in, length), "written from a registered buffer");
+    close(fd);
+}
+
+TEST(kernelPicksProvidedBlocksForPipeReads) {
+    auto ring = makeRing();
+    if (!ring) {
+        return;
+    }
+    RegisteredBufferPool pool(*ring, 4096, 8);
+    try {
+        pool.enableProvidedBuffers(7, 4);
+    } catch (const std::system_error& e) {
+        std::cout << "  provided-buffer rings unavailable, skipping: " << e.what() << '\n';
+        return;
+    }
+    CHECK_EQ(pool.provide(16), 4u);
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+
+    int fds[2];
+    CHECK_EQ(pipe(fds), 0);
+    CHECK_EQ(write(fds[1], "ping", 4), 4);
+    pool.prepareReadProvided(ring->getSqe(), fds[0], 4096, static_cast<std::uint64_t>(-1));
+    ring->submit();
+    io_uring_cqe cqe = ring->waitCqe();
+    CHECK_EQ(cqe.res, 4);
+    auto* block = static_cast<char*>(pool.takeProvided(cqe));
+    CHECK(block != nullptr);
+    CHECK_EQ(std::string(block, 4), "ping");
+    CHECK_EQ(pool.getProvidedCount(), 3u);
+
+    // Fixed-buffer index and provided buffer id are the same number
+    CHECK_EQ(pool.bufferIndex(block), static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+    pool.reprovide(block);
+    CHECK_EQ(pool.getProvidedCount(), 4u);
+    close(fds[0]);
+    close(fds[1]);
+}
@@ -0,0 +1,103 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "RelocatablePool.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+struct Record {
+    std::uint64_t id;
+    std::uint64_t payload[3];
+};
+
+} // namespace
+
+TEST(growsByChunks) {
+    RelocatablePool pool(sizeof(Record), 4);
+    std::vector<RelocatablePool::Handle> handles;
+    for (std::uint64_t i = 0; i < 9; ++i) {
+        handles.push_back(pool.allocate());
+        pool.get<Record>(handles.back())->id = i;
+    }
+    CHECK_EQ(pool.getChunkCount(), 3u);
+    CHECK_EQ(pool.getLiveCount(), 9u);
+    CHECK_EQ(pool.get<Record>(handles[5])->id, 5u);
+}
+
+TEST(limitsChunkCount) {
+    RelocatablePool pool(16, 2, 1);
+    pool.allocate();
+    pool.allocate();
+    CHECK_THROWS(pool.allocate(), std::bad_alloc);
+}
+
+TEST(staleHandlesResolveToNull) {
+    RelocatablePool pool(16, 4);
+    RelocatablePool::Handle handle = pool.allocate();
+    pool.deallocate(handle);
+    CHECK(pool.get(handle) == nullptr);
+    CHECK_THROWS(pool.deallocate(handle), std::invalid_argument);
+    RelocatablePool::Handle reused = pool.allocate();
+    CHECK_EQ(reused.index, handle.index);
+    CHECK(reused != handle);
+}
+
+TEST(compactionDrainsSparseChunksAndKeepsContents) {
+    RelocatablePool pool(sizeof(Record), 16);
+    std::vector<RelocatablePool::Handle> handles;
+    for (std::uint64_t i = 0; i < 16 * 8; ++i) {
+        handles.push_back(pool.allocate());
+        *pool.get<Record>(handles.back()) = Record{i, {i, i * 2, i * 3}};
+    }
+    // Free most blocks, leaving every chunk sparse
+    std::vector<RelocatablePool::Handle> survivors;
+    for (std::size_t i = 0; i < handles.size(); ++i) {
+        if (i % 8 == 0) {
+            survivors.push_back(handles[i]);
+        } else {
+            pool.deallocate(handles[i]);
+        }
+    }
+    CHECK_EQ(pool.getChunkCount(), 8u);
+
+    std::size_t steps = 0;
+    std::size_t moved = 0;
+    for (; pool.getChunkCount() > 1 && steps < 1000; ++steps) {
+        std::size_t stepMoves = pool.compactStep(4);
+        CHECK(stepMoves <= 4);
+        moved += stepMoves;
+    }
+    CHECK_EQ(pool.getChunkCount(), 1u);
+    CHECK(steps > 1); // Work was split across several bounded steps
+    CHECK(moved <= 16u); // Sparse chunks drain into the fullest one without churn
+
+    for (RelocatablePool::Handle handle : survivors) {
+        const Record* record = pool.get<Record>(handle);
+        CHECK(record != nullptr);
+        CHECK_EQ(record->payload[2], record->id * 3);
+    }
+}
+
+TEST(relocationHookSeesEveryMove) {
+    std::size_t moves = 0;
+    RelocatablePool pool(sizeof(std::uint64_t), 4, 8, [&](void* from, void* to, std::size_t size) {
+        ++moves;
+        std::memcpy(to, from, size);
+    });
+    std::vector<RelocatablePool::Handle> handles;
+    for (int i = 0; i < 8; ++i) {
+        handles.push_back(pool.allocate());
+    }
+    for (int i = 1; i < 8; ++i) {
+        if (i != 4) {
+            pool.deallocate(handles[i]);
+        }
+    }
+    for (int step = 0; step < 10; ++step) {
+        pool.compactStep(16);
+    }
+    CHECK_EQ(moves, 1u);
+    CHECK_EQ(pool.getLiveCount(), 2u);
+}
@@ -0,0 +1,117 @@
+#include <atomic>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "MemoryPool.hpp"
+#include "SegmentQueue.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+using SmallQueue = SegmentQueue<int, 4>;
+
+} // namespace
+
+TEST(poolBlocksMustHoldASegment) {
+    MemoryPool pool(SmallQueue::segmentBytes - 1, 4);
+    CHECK_THROWS(SmallQueue{pool}, std::invalid_argument);
+}
+
+TEST(fifoAcrossSegments) {
+    MemoryPool pool(SmallQueue::segmentBytes, 8);
+    SmallQueue queue(pool);
+    for (int i = 0; i < 10; ++i) {
+        queue.push(i);
+    }
+    CHECK_EQ(pool.getAvailableCount(), 5u); // Three segments in use
+    int value = -1;
+    for (int i = 0; i < 10; ++i) {
+        CHECK(queue.tryPop(value));
+        CHECK_EQ(value, i);
+    }
+    CHECK(!queue.tryPop(value));
+}
+
+TEST(drainedSegmentsAreRecycled) {
+    MemoryPool pool(SmallQueue::segmentBytes, 4);
+    SmallQueue queue(pool);
+    int value;
+    // Far more items than four segments hold, at a bounded depth
+    for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < 6; ++i) {
+            queue.push(round * 6 + i);
+        }
+        for (int i = 0; i < 6; ++i) {
+            CHECK(queue.tryPop(value));
+            CHECK_EQ(value, round * 6 + i);
+        }
+    }
+    CHECK(queue.getRecycledCount() > 250u);
+}
+
+TEST(exhaustedPoolThrows) {
+    MemoryPool pool(SmallQueue::segmentBytes, 2);
+    SmallQueue queue(pool);
+    for (int i = 0; i < 8; ++i) {
+        queue.push(i);
+    }
+    CHECK_THROWS(queue.push(8), std::bad_alloc);
+}
+
+TEST(destructorReleasesItemsAndSegments) {
+    MemoryPool pool(SegmentQueue<std::shared_ptr<int>, 4>::segmentBytes, 4);
+    auto shared = std::make_shared<int>(1);
+    {
+        SegmentQueue<std::shared_ptr<int>, 4> queue(pool);
+        for (int i = 0; i < 6; ++i) {
+            queue.push(shared);
+        }
+        std::shared_ptr<int> out;
+        queue.tryPop(out);
+        CHECK_EQ(shared.use_count(), 7);
+    }
+    CHECK_EQ(shared.use_count(), 1);
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+}
+
+TEST(concurrentProducersAndConsumersSeeEveryItemOnce) {
+    constexpr int producers = 3;
+    constexpr int consumers = 3;
+    constexpr int perProducer = 20000;
+    MemoryPool pool(SegmentQueue<int, 32>::segmentBytes, 4096);
+    SegmentQueue<int, 32> queue(pool);
+    std::vector<std::atomic<int>> seen(producers * perProducer);
+    std::atomic<int> consumed{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                queue.push(p * perProducer + i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            int value;
+            while (consumed.load() < producers * perProducer) {
+                if (queue.tryPop(value)) {
+                    seen[value].fetch_add(1);
+                    consumed.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    bool once = true;
+    for (std::atomic<int>& count : seen) {
+        once = once && count.load() == 1;
+    }
+    CHECK(once);
+}
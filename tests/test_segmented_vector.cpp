@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.hpp"
+#include "SegmentedVector.hpp"
+#include "TestHarness.hpp"
+
+TEST(segmentIsOnePoolBlock) {
+    MemoryPool pool(64, 8);
+    segmented_vector<int> vector(pool);
+    CHECK_EQ(vector.segment_capacity(), 16u);
+    CHECK_EQ(vector.segment_count(), 0u);
+    for (int i = 0; i < 17; ++i) {
+        vector.push_back(i);
+    }
+    CHECK_EQ(vector.segment_count(), 2u);
+    CHECK_EQ(pool.getAvailableCount(), 6u);
+    CHECK_EQ(vector[16], 16);
+    CHECK_EQ(vector.back(), 16);
+}
+
+TEST(segmentCapacityRoundsDownToAPowerOfTwo) {
+    MemoryPool pool(100, 4);
+    SegmentedVector<int> vector(pool); // 25 ints fit, 16 are used
+    CHECK_EQ(vector.segment_capacity(), 16u);
+    MemoryPool tiny(2, 1);
+    CHECK_THROWS(SegmentedVector<int>{tiny}, std::invalid_argument);
+}
+
+TEST(addressesStayStableAcrossAppends) {
+    MemoryPool pool(sizeof(std::string) * 4, 64);
+    SegmentedVector<std::string> vector(pool);
+    std::vector<const std::string*> addresses;
+    for (int i = 0; i < 100; ++i) {
+        addresses.push_back(&vector.emplace_back(std::to_string(i)));
+    }
+    for (int i = 0; i < 100; ++i) {
+        CHECK(&vector[i] == addresses[i]);
+        CHECK_EQ(*addresses[i], std::to_string(i));
+    }
+    vector.push_back(vector.front()); // Reference into the vector is never moved
+    CHECK_EQ(vector.back(), "0");
+}
+
+TEST(popBackAndClearReturnSegments) {
+    MemoryPool pool(32, 4);
+    SegmentedVector<std::shared_ptr<int>> vector(pool);
+    auto counted = std::make_shared<int>(1);
+    std::size_t perSegment = vector.segment_capacity();
+    for (std::size_t i = 0; i < perSegment + 1; ++i) {
+        vector.push_back(counted);
+    }
+    CHECK_EQ(vector.segment_count(), 2u);
+    vector.pop_back();
+    CHECK_EQ(vector.segment_count(), 1u);
+    CHECK_EQ(pool.getAvailableCount(), 3u);
+    CHECK_EQ(counted.use_count(), static_cast<long>(perSegment + 1));
+    vector.clear();
+    CHECK(vector.empty());
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+    CHECK_EQ(counted.use_count(), 1);
+}
+
+TEST(exhaustedPoolLeavesTheVectorIntact) {
+    MemoryPool pool(16, 1);
+    SegmentedVector<int> vector(pool);
+    for (int i = 0; i < 4; ++i) {
+        vector.push_back(i);
+    }
+    CHECK_THROWS(vector.push_back(4), std::bad_alloc);
+    CHECK_EQ(vector.size(), 4u);
+    CHECK_EQ(vector.segment_count(), 1u);
+    CHECK_THROWS(vector.at(4), std::out_of_range);
+}
+
+TEST(iteratorsAreRandomAccess) {
+    MemoryPool pool(16, 8);
+    SegmentedVector<int> vector(pool);
+    for (int i = 9; i >= 0; --i) {
+        vector.push_back(i);
+    }
+    std::sort(vector.begin(), vector.end());
+    const SegmentedVector<int>& view = vector;
+    int expected = 0;
+    for (int value : view) {
+        CHECK_EQ(value, expected++);
+    }
+    CHECK_EQ(view.end() - view.begin(), 10);
+    CHECK_EQ(*(vector.begin() + 5), 5);
+
+    SegmentedVector<int> moved(std::move(vector));
+    CHECK_EQ(moved.size(), 10u);
+    CHECK(vector.empty());
+    CHECK_EQ(vector.segment_count(), 0u);
+}
+
+TEST(segmentTableGrowsGeometrically) {
+    MemoryPool pool(16, 4096);
+    SegmentedVector<int> vector(pool); // Four ints per segment
+    std::size_t before = heapAllocations;
+    for (int i = 0; i < 4 * 4096; ++i) {
+        vector.push_back(i);
+    }
+    CHECK_EQ(vector.segment_count(), 4096u);
+    CHECK(heapAllocations - before <= 16u); // Table reallocations only
+}
@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "SharedMemoryPool.hpp"
+#include "TestHarness.hpp"
+
+namespace {
+
+struct Message {
+    std::uint64_t length;
+    char text[120];
+};
+
+// Runs body in a forked child and returns its exit status
+template <typename Body>
+int runInChild(Body body) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        _exit(body());
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+} // namespace
+
+TEST(childAllocatesParentFrees) {
+    SharedMemoryPool pool(sizeof(Message), 8);
+    int fds[2];
+    CHECK_EQ(pipe(fds), 0);
+
+    int status = runInChild([&] {
+        auto* message = static_cast<Message*>(pool.allocate());
+        std::strcpy(message->text, "hello from the child");
+        message->length = std::strlen(message->text);
+        std::uint64_t offset = pool.toOffset(message);
+        return write(fds[1], &offset, sizeof(offset)) == sizeof(offset) ? 0 : 1;
+    });
+    CHECK_EQ(status, 0);
+
+    std::uint64_t offset = 0;
+    CHECK_EQ(read(fds[0], &offset, sizeof(offset)), static_cast<ssize_t>(sizeof(offset)));
+    auto* message = static_cast<Message*>(pool.fromOffset(offset));
+    CHECK(pool.owns(message));
+    CHECK_EQ(std::string(message->text, message->length), "hello from the child");
+    CHECK_EQ(pool.getAvailableCount(), 7u);
+    pool.deallocate(message);
+    CHECK_EQ(pool.getAvailableCount(), 8u);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(namedSegmentAttachesAtAnyAddress) {
+    std::string name = "/mpm-test-" + std::to_string(getpid());
+    SharedMemoryPool::unlink(name);
+    SharedMemoryPool pool(name, 64, 4);
+
+    int status = runInChild([&] {
+        // A fresh attachment maps the segment at a different address
+        SharedMemoryPool attached(name);
+        if (attached.getBlockSize() != 64 || attached.getCapacity() != 4) {
+            return 1;
+        }
+        void* first = attached.allocate();
+        void* second = attached.allocate();
+        attached.deallocate(first);
+        return attached.toOffset(second) != 0 ? 0 : 2;
+    });
+    CHECK_EQ(status, 0);
+    CHECK_EQ(pool.getAvailableCount(), 3u);
+    SharedMemoryPool::unlink(name);
+    CHECK_THROWS(SharedMemoryPool(name), std::system_error);
+}
+
+TEST(failedCreationRemovesTheNamedSegment) {
+    std::string name = "/mpm-test-failed-" + std::to_string(getpid());
+    SharedMemoryPool::unlink(name);
+    CHECK_THROWS(SharedMemoryPool(name, 4, 4), std::invalid_argument);
+    CHECK_THROWS(SharedMemoryPool(name), std::system_error);
+    SharedMemoryPool pool(name, 64, 4); // The name is free again
+    CHECK_EQ(pool.getCapacity(), 4u);
+    SharedMemoryPool::unlink(name);
+}
+
+TEST(recoversWhenLockHolderDies) {
+    SharedMemoryPool pool(32, 4);
+    void* block = pool.allocate();
+
+    int status = runInChild([&] {
+        auto* header = static_cast<SharedPoolHeader*>(
+            mmap(nullptr, sizeof(SharedPoolHeader), PROT_READ | PROT_WRITE, MAP_SHARED, pool.descriptor(), 0));
+        pthread_mutex_lock(&header->mutex);
+        header->freeCount = 99; // Half-finished update left behind
+        return 0; // Exits while holding the lock
+    });
+    CHECK_EQ(status, 0);
+
+    pool.deallocate(block);
+    CHECK_EQ(pool.getAvailableCount(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        pool.allocate();
+    }
+    CHECK_THROWS(pool.allocate(), std::bad_alloc);
+}
@@ -0,0 +1,45 @@
+#include "SizeClassedPool.hpp"
+#include "TestHarness.hpp"
+
+TEST(roundsRequestsToSizeClasses) {
+    SizeClassedPool pools(4);
+    CHECK_EQ(&pools.poolFor(1), &pools.poolFor(SizeClassedPool::granularity));
+    CHECK(&pools.poolFor(1) != &pools.poolFor(SizeClassedPool::granularity + 1));
+    CHECK_EQ(pools.poolFor(24).getBlockSize(), SizeClassedPool::roundUp(24));
+    CHECK_EQ(pools.poolFor(24).getCapacity(), 4u);
+}
+
+TEST(allocateAndDeallocateReturnToClass) {
+    SizeClassedPool pools(2);
+    MemoryPool& pool = pools.poolFor(40);
+    void* a = pools.allocate(40);
+    void* b = pools.allocate(33);
+    CHECK_EQ(pool.getAvailableCount(), 0u);
+    CHECK_THROWS(pools.allocate(48), std::bad_alloc);
+    pools.deallocate(a, 40);
+    pools.deallocate(b, 33);
+    CHECK_EQ(pool.getAvailableCount(), 2u);
+}
+
+TEST(oversizedRequestsBypassPools) {
+    SizeClassedPool pools(1, 64);
+    CHECK(!pools.isPooled(65));
+    void* large = pools.allocate(4096);
+    CHECK(large != nullptr);
+    pools.deallocate(large, 4096);
+}
+
+TEST(arrayClassesKeepTwoBlocksAndGrowWhenDry) {
+    SizeClassedPool pools(4, 4096);
+    MemoryPool& pool = pools.poolFor(4096);
+    CHECK_EQ(pool.getCapacity(), 2u);
+    void* blocks[5];
+    for (void*& block : blocks) {
+        block = pools.allocate(4096);
+    }
+    CHECK_EQ(pool.getCapacity(), 6u);
+    for (void* block : blocks) {
+        pools.deallocate(block, 4096);
+    }
+    CHECK_EQ(pool.getAvailableCount(), 6u);
+}
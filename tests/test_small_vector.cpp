@@ -0,0 +1,135 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "AllocationCounter.hpp"
+#include "SmallVector.hpp"
+#include "TestHarness.hpp"
+
+TEST(staysInlineUpToN) {
+    SizeClassedPool pools(16);
+    pools.poolFor(64); // Create the size classes before counting
+    std::size_t before = heapAllocations;
+    {
+        small_vector<int, 8> vector(pools);
+        for (int i = 0; i < 8; ++i) {
+            vector.push_back(i);
+        }
+        CHECK(vector.is_inline());
+        CHECK_EQ(vector.capacity(), 8u);
+        vector.push_back(8); // Spills into a 64-byte block of the pool
+        CHECK(!vector.is_inline());
+        CHECK_EQ(vector.capacity(), 16u);
+        CHECK_EQ(vector[8], 8);
+        CHECK_EQ(pools.poolFor(64).getAvailableCount(), 15u);
+    }
+    CHECK_EQ(heapAllocations, before);
+    CHECK_EQ(pools.poolFor(64).getAvailableCount(), 16u);
+}
+
+TEST(growthKeepsElementsInOrder) {
+    SizeClassedPool pools(16, 1024);
+    small_vector<std::string, 2> vector(pools);
+    for (int i = 0; i < 40; ++i) {
+        vector.emplace_back(std::to_string(i));
+    }
+    CHECK_EQ(vector.size(), 40u);
+    for (int i = 0; i < 40; ++i) {
+        CHECK_EQ(vector[i], std::to_string(i));
+    }
+    vector.push_back(vector.front()); // Reference into the vector across growth
+    CHECK_EQ(vector.back(), "0");
+}
+
+TEST(moveStealsThePoolBlock) {
+    SizeClassedPool pools(16);
+    small_vector<int, 4> source(pools);
+    for (int i = 0; i < 10; ++i) {
+        source.push_back(i);
+    }
+    const int* block = source.data();
+    small_vector<int, 4> target(std::move(source));
+    CHECK(target.data() == block);
+    CHECK_EQ(target.size(), 10u);
+    CHECK(source.empty());
+    CHECK(source.is_inline());
+
+    small_vector<int, 4> assigned(pools, {1, 2});
+    assigned = std::move(target);
+    CHECK(assigned.data() == block);
+    CHECK_EQ(assigned[9], 9);
+}
+
+TEST(moveOfInlineElementsRelocates) {
+    SizeClassedPool pools(4);
+    small_vector<std::unique_ptr<int>, 4> source(pools);
+    source.push_back(std::make_unique<int>(7));
+    small_vector<std::unique_ptr<int>, 4> target(std::move(source));
+    CHECK(target.is_inline());
+    CHECK_EQ(*target[0], 7);
+    CHECK(source.empty());
+}
+
+TEST(copyInsertEraseAndResize) {
+    SizeClassedPool pools(16);
+    small_vector<int, 4> vector(pools, {1, 2, 4});
+    vector.insert(vector.begin() + 2, 3);
+    small_vector<int, 4> copy(vector);
+    CHECK(copy == vector);
+    CHECK_EQ(copy[2], 3);
+    vector.erase(vector.begin());
+    CHECK_EQ(vector.front(), 2);
+    CHECK(copy != vector);
+    vector.resize(6, 9);
+    CHECK_EQ(vector.size(), 6u);
+    CHECK_EQ(vector.back(), 9);
+    vector.resize(1);
+    CHECK_EQ(vector.size(), 1u);
+    CHECK_THROWS(vector.at(1), std::out_of_range);
+}
+
+namespace {
+
+// Copying throws once copiesLeft runs out; moving may throw, so growth copies
+struct FragileCopy {
+    static int copiesLeft;
+    int value;
+
+    explicit FragileCopy(int value) : value(value) {}
+
+    FragileCopy(const FragileCopy& other) : value(other.value) {
+        if (copiesLeft-- == 0) {
+            throw std::runtime_error("copy");
+        }
+    }
+
+    FragileCopy(FragileCopy&& other) : value(other.value) {}
+};
+
+int FragileCopy::copiesLeft = 1 << 20;
+
+} // namespace
+
+TEST(throwingGrowthKeepsElementsAndReturnsTheBlock) {
+    SizeClassedPool pools(4, 1024);
+    small_vector<FragileCopy, 2> vector(pools);
+    for (int i = 0; i < 4; ++i) {
+        vector.emplace_back(i);
+    }
+    std::size_t capacity = vector.capacity();
+    std::size_t idle = pools.poolFor(capacity * 2 * sizeof(FragileCopy)).getAvailableCount();
+    FragileCopy::copiesLeft = 2;
+    CHECK_THROWS(vector.reserve(capacity * 2), std::runtime_error);
+    CHECK_EQ(pools.poolFor(capacity * 2 * sizeof(FragileCopy)).getAvailableCount(), idle);
+    CHECK_EQ(vector.capacity(), capacity);
+    for (int i = 0; i < 4; ++i) {
+        CHECK_EQ(vector[i].value, i);
+    }
+}
+
+TEST(relocatableTraitCoversTrivialTypesAndUniquePtr) {
+    CHECK(trivially_relocatable<int>::value);
+    CHECK(trivially_relocatable<std::unique_ptr<int>>::value);
+    CHECK(!trivially_relocatable<std::string>::value);
+}
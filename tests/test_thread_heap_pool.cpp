@@ -0,0 +1,107 @@
+#include <atomic>
+#include <new>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "MpmcRing.hpp"
+#include "TestHarness.hpp"
+#include "ThreadHeapPool.hpp"
+
+TEST(localFreesAreReusedFirst) {
+    ThreadHeapPool pool(32, 4);
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    pool.deallocate(a);
+    CHECK(pool.allocate() == a);
+    pool.deallocate(b);
+    CHECK_EQ(pool.getRemoteFreeCount(), 0u);
+    CHECK_EQ(pool.getHeapCount(), 1u);
+    CHECK_THROWS(ThreadHeapPool(0, 4), std::invalid_argument);
+}
+
+TEST(heapIsBoundedPerThread) {
+    ThreadHeapPool pool(16, 8);
+    std::set<void*> seen;
+    for (int i = 0; i < 8; ++i) {
+        seen.insert(pool.allocate());
+    }
+    CHECK_EQ(seen.size(), 8u);
+    CHECK_THROWS(pool.allocate(), std::bad_alloc);
+    std::thread other([&] {
+        void* block = pool.allocate(); // Another thread has a heap of its own
+        CHECK(seen.count(block) == 0);
+        pool.deallocate(block);
+    });
+    other.join();
+    CHECK_EQ(pool.getHeapCount(), 2u);
+}
+
+TEST(foreignFreesGoBackToTheOwnerInOneBatch) {
+    ThreadHeapPool pool(32, 4);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 4; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    CHECK_THROWS(pool.allocate(), std::bad_alloc);
+    std::thread consumer([&] {
+        for (void* block : blocks) {
+            pool.deallocate(block);
+        }
+    });
+    consumer.join();
+    CHECK_EQ(pool.getRemoteFreeCount(), 4u);
+    std::set<void*> again;
+    for (int i = 0; i < 4; ++i) {
+        again.insert(pool.allocate()); // The first allocation drains the whole list
+    }
+    CHECK(again == std::set<void*>(blocks.begin(), blocks.end()));
+    CHECK_EQ(pool.getHeapCount(), 1u); // The consumer never needed a heap
+}
+
+TEST(exitedThreadsHeapIsAdopted) {
+    ThreadHeapPool pool(32, 4);
+    void* kept = nullptr;
+    std::thread first([&] { kept = pool.allocate(); });
+    first.join();
+    std::thread second([&] {
+        pool.deallocate(kept);
+        for (int i = 0; i < 4; ++i) {
+            pool.allocate(); // Adopted heap: the remote free plus three fresh blocks
+        }
+    });
+    second.join();
+    CHECK_EQ(pool.getHeapCount(), 1u);
+}
+
+TEST(producerConsumerPipeline) {
+    constexpr int items = 50000;
+    ThreadHeapPool pool(sizeof(int), 256);
+    MpmcRing<int*> ring(128);
+    std::atomic<bool> corrupt{false};
+    std::thread producer([&] {
+        for (int i = 0; i < items; ++i) {
+            int* value = new (pool.allocate()) int(i);
+            while (!ring.tryPush(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::thread consumer([&] {
+        for (int i = 0; i < items; ++i) {
+            int* value;
+            while (!ring.tryPop(value)) {
+                std::this_thread::yield();
+            }
+            if (*value != i) {
+                corrupt = true;
+            }
+            pool.deallocate(value);
+        }
+    });
+    producer.join();
+    consumer.join();
+    CHECK(!corrupt.load());
+    CHECK_EQ(pool.getRemoteFreeCount(), static_cast<std::size_t>(items));
+}
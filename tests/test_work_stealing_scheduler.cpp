@@ -0,0 +1,91 @@
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include "TestHarness.hpp"
+#include "WorkStealingScheduler.hpp"
+
+namespace {
+
+void fib(WorkStealingScheduler& scheduler, int n, std::atomic<long>& leaves) {
+    if (n < 2) {
+        leaves.fetch_add(1);
+        return;
+    }
+    scheduler.spawn([&scheduler, n, &leaves] { fib(scheduler, n - 1, leaves); });
+    scheduler.spawn([&scheduler, n, &leaves] { fib(scheduler, n - 2, leaves); });
+}
+
+} // namespace
+
+TEST(dequeIsLifoForOwnerAndFifoForThieves) {
+    ChaseLevDeque<int*> deque(4);
+    int items[5] = {};
+    for (int i = 0; i < 4; ++i) {
+        CHECK(deque.push(&items[i]));
+    }
+    CHECK(!deque.push(&items[4]));
+    CHECK(deque.steal() == &items[0]);
+    CHECK(deque.take() == &items[3]);
+    CHECK(deque.take() == &items[2]);
+    CHECK(deque.steal() == &items[1]);
+    CHECK(deque.take() == nullptr);
+    CHECK(deque.steal() == nullptr);
+    CHECK_THROWS(ChaseLevDeque<int*>(3), std::invalid_argument);
+}
+
+TEST(runsEveryTaskOfAForkTree) {
+    std::atomic<long> leaves{0};
+    WorkStealingScheduler scheduler(4);
+    scheduler.spawn([&] { fib(scheduler, 18, leaves); });
+    scheduler.wait();
+    CHECK_EQ(leaves.load(), 4181L); // fib(19) leaves in the call tree of fib(18)
+}
+
+TEST(stolenTasksAreFreedToTheirOwner) {
+    constexpr int children = 100;
+    WorkStealingScheduler scheduler(3);
+    std::atomic<int> done{0};
+    std::atomic<unsigned> parentWorker{0};
+    std::atomic<bool> allStolen{true};
+    scheduler.spawn([&] {
+        parentWorker = scheduler.currentWorker();
+        for (int i = 0; i < children; ++i) {
+            scheduler.spawn([&] {
+                if (scheduler.currentWorker() == parentWorker.load()) {
+                    allStolen = false;
+                }
+                done.fetch_add(1);
+            });
+        }
+        // Never returns to its own deque, so every child must be stolen
+        while (done.load() < children) {
+            std::this_thread::yield();
+        }
+    });
+    scheduler.wait();
+    CHECK(allStolen.load());
+    CHECK(scheduler.getStealCount() >= static_cast<std::size_t>(children));
+    CHECK(scheduler.getRemoteFreeCount() >= static_cast<std::size_t>(children));
+}
+
+TEST(fullDequeRunsInline) {
+    WorkStealingScheduler scheduler(1, 128, 64, 4);
+    std::atomic<int> done{0};
+    scheduler.spawn([&] {
+        for (int i = 0; i < 10; ++i) {
+            scheduler.spawn([&] { done.fetch_add(1); });
+        }
+    });
+    scheduler.wait();
+    CHECK_EQ(done.load(), 10);
+    CHECK_EQ(scheduler.getInlineCount(), 6u);
+}
+
+TEST(closureMustFitTheBlock) {
+    WorkStealingScheduler scheduler(1, 64);
+    char big[128] = {};
+    CHECK_THROWS(scheduler.spawn([big] { (void)big; }), std::bad_alloc);
+    CHECK_THROWS(WorkStealingScheduler(0), std::invalid_argument);
+}